@@ -0,0 +1,84 @@
+/**
+ * @file Animation.h
+ * @brief Queued, timed LCD effects rendered from serviceTick()
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Typewriter text, confirmation toasts, exit messages and the tip
+ * pages used to be drawn with delay() between frames, freezing buttons and the
+ * auto-mode schedule for up to several seconds. They are now queued as steps
+ * and drawn by animationService() from every service tick, so the code that
+ * queues them carries on at once.
+ *
+ * Each step is shown for its hold time; a typewriter step prints one character
+ * per hold time. When the queue drains the LCD is cleared, so whichever screen
+ * is current draws itself again. While animationActive(), screens leave the LCD
+ * alone and treat a button press as "skip" (animationSkip()).
+ *
+ * Step text is not copied: it must outlive the step (a literal or a static
+ * buffer).
+ */
+
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <Arduino.h>
+
+#include "Display.h"
+
+/**
+ * @name Step Flags
+ * @{
+ */
+const uint8_t ANIMATE_CLEAR = 0x01; ///< Clear the LCD before the step
+const uint8_t ANIMATE_TYPE = 0x02;  ///< Typewriter, one character per holdMs
+/** @} */
+
+/**
+ * @brief Attaches the engine to the LCD
+ * @param display Display the effects are drawn on
+ */
+void animationBegin(Display &display);
+
+/**
+ * @brief Appends one step
+ * @param text Text to print, or nullptr for a pause
+ * @param col Column of the first character
+ * @param row Row
+ * @param holdMs How long the step stays (per character when ANIMATE_TYPE)
+ * @param flags ANIMATE_* bits
+ * @return false if the queue was full and the step was dropped
+ */
+bool animationQueue(const char *text, uint8_t col, uint8_t row, uint16_t holdMs,
+                    uint8_t flags = 0);
+
+/**
+ * @brief Queues a two-row message on a cleared screen
+ * @param top First-row text
+ * @param bottom Second-row text
+ * @param holdMs How long it stays up
+ */
+void animationToast(const char *top, const char *bottom, uint16_t holdMs);
+
+/**
+ * @brief Draws whatever frames are due; call from every service tick
+ */
+void animationService();
+
+/**
+ * @brief Reports whether an effect owns the LCD
+ */
+bool animationActive();
+
+/**
+ * @brief Milliseconds until the engine next has to draw
+ * @return 0xFFFFFFFF when idle, so callers can sleep on min() of it
+ */
+unsigned long animationDueIn();
+
+/**
+ * @brief Drops every queued step and clears the LCD
+ */
+void animationSkip();
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file Display.h
+ * @brief 16x2 LCD front end with headless detection and a Serial mirror
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Display is a drop-in for the LiquidCrystal_I2C calls the firmware
+ * makes. Every character also goes into a 32-byte RAM copy of the screen, so:
+ * - init() probes the PCF8574 backpack once; when it does not acknowledge,
+ *   all LCD traffic is skipped instead of timing out on every write.
+ * - The RAM frame can be mirrored over Serial as TELEMETRY_LCD records, one
+ *   per changed row and at most every mirrorInterval ms, so the UI can be
+ *   watched remotely. A row redrawn with the same text (clear then reprint)
+ *   is not resent. Mirroring starts automatically on a headless unit.
+ *
+ * Build with -DHEADLESS (env:uno_headless) to leave the LCD driver out
+ * entirely on units that never have a display.
+ */
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <Arduino.h>
+
+#include "HardwareProfile.h"
+
+#ifndef HEADLESS
+#include <LiquidCrystal_I2C.h>
+#endif
+
+class Display : public Print {
+public:
+  Display();
+
+  /**
+   * @brief Probes the backpack and initialises the LCD if it answers
+   */
+  void init();
+
+  /**
+   * @brief Reports whether an LCD acknowledged at boot
+   */
+  bool isPresent() const { return present_; }
+
+  /**
+   * @name LiquidCrystal_I2C Interface
+   * @brief Same calls as the driver; no-ops on the bus when headless
+   * @{
+   */
+  void clear();
+  void setCursor(uint8_t col, uint8_t row);
+  void backlight();
+  void noBacklight();
+  void blink();
+  void noBlink();
+  size_t write(uint8_t c) override;
+  using Print::write;
+  /** @} */
+
+  /**
+   * @brief Turns the Serial mirror on or off
+   * @details Turning it on queues the whole current frame.
+   */
+  void setMirror(bool enabled);
+  bool isMirroring() const { return mirror_; }
+
+  /**
+   * @brief Sends changed rows as telemetry; call from the service loop
+   */
+  void service();
+
+private:
+  static const uint8_t cols = Hw::lcdCols;
+  static const uint8_t rows = Hw::lcdRows;
+  static const unsigned int mirrorInterval = 250; ///< Coalesces bursts of edits
+
+#ifndef HEADLESS
+  LiquidCrystal_I2C lcd_;
+#endif
+  char frame_[rows][cols];
+  uint8_t col_;
+  uint8_t row_;
+  uint8_t dirtyRows_; ///< Bit per row written since it was last mirrored
+  uint16_t sentCrc_[rows]; ///< CRC of each row as last mirrored
+  bool present_;
+  bool mirror_;
+  unsigned long lastMirror_;
+};
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @file EventLog.h
+ * @brief Persistent log of waterings, skipped waterings and faults
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Two tiers, both surviving power loss:
+ * - Hot tail: the newest few events in the DS1302's 31 bytes of
+ *   battery-backed RAM, rewritten with one burst transfer per event. RTC RAM
+ *   has no write endurance limit.
+ * - Ring: full batches of eventLogBatch events are appended to a ring of
+ *   eventLogSlots records at the top of the EEPROM (EEPROM.update(), so only
+ *   changed bytes cost a write cycle). At one batch a day that is decades of
+ *   wear.
+ *
+ * Each record is 7 bytes: kind, detail, 16-bit value and a 24-bit RTC
+ * timestamp in minutes since 2024 (good until 2055). In the EEPROM the top
+ * bit of the kind byte flips on every lap of the ring, which is how the write
+ * position is found again at boot without a separately stored (and
+ * separately worn) pointer.
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+#include <RtcDS1302.h>
+
+/**
+ * @brief What happened
+ */
+enum EventKind : uint8_t {
+  EVENT_BOOT = 1,       ///< Power-up; detail: SupervisorFault behind a reset
+  EVENT_WATERED = 2,    ///< Pump run; detail: TelemetryPumpReason, value: ml
+  EVENT_SKIP_TANK = 3,  ///< Watering skipped, tank low; detail: reason
+  EVENT_SKIP_WET = 4,   ///< Skipped, soil wet; detail: reason, value: %
+  EVENT_SKIP_SPILL = 5, ///< Skipped, spill probe wet; value: probe reading
+  EVENT_FAULT = 6,      ///< Supervisor fault; detail: SupervisorFault
+  EVENT_TANK_LOW = 7,   ///< Float switch tripped and settled
+  EVENT_REFILLED = 8,   ///< Float switch cleared and settled
+};
+
+/**
+ * @brief One logged event
+ */
+struct EventRecord {
+  uint8_t kind;     ///< EventKind
+  uint8_t detail;   ///< Kind-specific code
+  uint16_t value;   ///< Kind-specific quantity
+  uint32_t minutes; ///< RTC time, minutes since eventLogEpoch
+};
+
+/**
+ * @name Layout
+ * @{
+ */
+const uint8_t eventLogBatch = 4;        ///< Hot-tail events per EEPROM flush
+const uint16_t eventLogEepromBase = 512; ///< First EEPROM byte of the ring
+const uint8_t eventLogSlots = 73;       ///< Ring capacity (7 bytes each)
+const uint32_t eventLogEpoch = 757382400UL; ///< 2024-01-01, s since 2000
+/** @} */
+
+/**
+ * @brief Reloads the hot tail from RTC RAM and finds the EEPROM ring head
+ * @param rtc Clock providing timestamps and the battery-backed RAM
+ */
+void eventLogBegin(RtcDS1302<ThreeWire> &rtc);
+
+/**
+ * @brief Records an event stamped with the current RTC time
+ */
+void eventLogAdd(EventKind kind, uint8_t detail, uint16_t value);
+
+/**
+ * @brief Number of events held (ring and hot tail)
+ */
+uint8_t eventLogCount();
+
+/**
+ * @brief Reads an event
+ * @param age 0 for the newest, eventLogCount() - 1 for the oldest
+ * @param record Filled in on success
+ * @return false if there is no such event
+ */
+bool eventLogGet(uint8_t age, EventRecord &record);
+
+/**
+ * @brief Describes an event in at most 16 characters (e.g. "Skip: wet 82%")
+ * @param record Event to describe
+ * @param text Buffer for the text
+ * @param size Buffer size (17 for a full LCD row)
+ */
+void eventLogDescribe(const EventRecord &record, char *text, uint8_t size);
+
+/**
+ * @brief Formats an event's timestamp as "YYYY-MM-DD HH:MM"
+ * @param record Event whose time to format
+ * @param text Buffer for the text
+ * @param size Buffer size (17 for the whole text)
+ * @details Skip the first 5 characters for the LCD form "MM-DD HH:MM".
+ */
+void eventLogFormatTime(const EventRecord &record, char *text, uint8_t size);
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file FlowMeter.h
+ * @brief Pulse-counting hall-effect flow sensor
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details The sensor output goes to Hw::flowMeter on PORTC. Rising edges are
+ * counted in the PCINT1 interrupt, so no pulse is missed while the firmware
+ * is busy or napping. Volume is derived from Hw::flowPulsesPerLitre.
+ *
+ * On the host the pulses come from a native::pulseSource() whose rate follows
+ * the pump PWM duty; flowBegin() attaches a nominal one if the harness has
+ * not set up its own (set its rate to 0 to simulate a dry pump).
+ *
+ * Only used when Hw::hasFlowMeter is set.
+ */
+
+#ifndef FLOW_METER_H
+#define FLOW_METER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Configures the input and enables the pin-change interrupt
+ */
+void flowBegin();
+
+/**
+ * @brief Pulses counted since boot
+ * @details Free-running; take differences to measure a run.
+ */
+uint32_t flowPulses();
+
+/**
+ * @brief Converts a pulse count to millilitres
+ * @param pulses Pulses (usually a difference of flowPulses())
+ */
+uint16_t flowPulsesToMillilitres(uint32_t pulses);
+
+#endif
@@ -0,0 +1,211 @@
+/**
+ * @file HardwareProfile.h
+ * @brief Per-revision hardware configuration resolved at compile time
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Every pin, calibration constant and optional feature of a board
+ * revision lives in one struct of static constexpr members. The build picks a
+ * revision with -DHW_REV (see platformio.ini) and the firmware refers to it as
+ * Hw, so each image constant-folds its own configuration and code behind a
+ * false feature flag is dropped by the optimizer.
+ *
+ * Later revisions inherit from the previous one and override only what
+ * changed on the board.
+ */
+
+#ifndef HARDWARE_PROFILE_H
+#define HARDWARE_PROFILE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Prototype 1: loose harness wired as in assets/wiring_diagram.png
+ */
+struct HardwareRev10 {
+  /**
+   * @name LCD
+   * @brief 16x2 character LCD behind a PCF8574 I2C backpack
+   * @{
+   */
+  static constexpr uint8_t lcdAddress = 0x27; ///< PCF8574 I2C address
+  static constexpr uint8_t lcdCols = 16;      ///< Characters per row
+  static constexpr uint8_t lcdRows = 2;       ///< Number of rows
+  /** @} */
+
+  /**
+   * @name RTC
+   * @brief DS1302 three-wire interface
+   * @{
+   */
+  static constexpr uint8_t rtcClk = 7; ///< Clock pin for DS1302 RTC
+  static constexpr uint8_t rtcDat = 6; ///< Data pin for DS1302 RTC
+  static constexpr uint8_t rtcRst = 8; ///< Reset pin for DS1302 RTC
+  /** @} */
+
+  /**
+   * @name Buttons
+   * @brief Active-low navigation buttons with internal pull-ups
+   * @{
+   */
+  static constexpr uint8_t buttonMinus = 2; ///< (-) button
+  static constexpr uint8_t buttonPlus = 3;  ///< (+) button
+  static constexpr uint8_t buttonM = 4;     ///< (M) button
+  static constexpr uint8_t buttonA = 5;     ///< (A) button
+  static constexpr uint8_t debounceDuration = 100; ///< Debounce time (ms)
+  /** @} */
+
+  /**
+   * @name Sensors
+   * @brief Soil moisture probe, water detection probe and tank float switch
+   * @{
+   */
+  static constexpr uint8_t soilPower = 11;        ///< Soil sensor supply
+  static constexpr uint8_t soilRead = A2;         ///< Soil sensor analog out
+  static constexpr uint8_t waterDetectPower = 13; ///< Water probe supply
+  static constexpr uint8_t waterDetectRead = A3;  ///< Water probe analog out
+  static constexpr uint8_t floatSwitch = 12;      ///< Tank float switch
+  static constexpr uint16_t dryValue = 300;       ///< Raw ADC, dry soil
+  static constexpr uint16_t wetValue = 880;       ///< Raw ADC, wet soil
+  static constexpr uint16_t waterDetectThreshold = 350; ///< Raw ADC, spill
+  static constexpr uint16_t soilWakeRaw = 415; ///< Raw ADC at AIN0, soil wake
+  /** @} */
+
+  /**
+   * @name Pump
+   * @brief Pump MOSFET (PWM) and solenoid valve relay
+   * @{
+   */
+  static constexpr uint8_t pumpValve = 9;          ///< Valve relay pin
+  static constexpr uint8_t pump = 10;              ///< Pump PWM pin
+  static constexpr uint16_t pumpValveTiming = 2000; ///< Valve settle (ms)
+  static constexpr uint8_t pumpHighSetting = 255;  ///< Full speed PWM
+  static constexpr uint8_t pumpMinSpeedPercent = 30; ///< Slowest that primes
+  static constexpr uint16_t pumpSmallDoseMl = 100; ///< Below: slow down
+  static constexpr uint16_t pumpMinDoseMs = 4000;  ///< Shortest slow run
+  /** @} */
+
+  /**
+   * @name Pump Thermal
+   * @brief Heat budget of the pump motor (see PumpDrive.h); heat is counted
+   * in ms of running at full duty
+   * @{
+   */
+  static constexpr uint32_t pumpHeatBudgetMs = 240000UL; ///< Most it may hold
+  static constexpr uint16_t pumpThermalTauS = 900;       ///< Cooling constant
+  static constexpr uint16_t pumpStartHeatMs = 2000;      ///< Cost of a start
+  /** @} */
+
+  /**
+   * @name Flow Meter
+   * @brief Hall-effect flow sensor (YF-S401) counted on a pin-change interrupt
+   * @{
+   */
+  static constexpr uint8_t flowMeter = A0;              ///< Sensor signal
+  static constexpr uint16_t flowPulsesPerLitre = 5880;  ///< Sensor K-factor
+  static constexpr uint16_t flowStallTimeout = 3000;    ///< No pulses (ms)
+  static constexpr uint16_t flowFallbackMsPerCup = 15000; ///< Uncalibrated
+  /** @} */
+
+  /**
+   * @name Tank
+   * @brief Reservoir size and where the float switch sits
+   * @{
+   */
+  static constexpr uint16_t tankCapacityMl = 2000; ///< Full tank
+  static constexpr uint16_t tankLowMarkMl = 250;   ///< Left when switch trips
+  static constexpr uint16_t tankWarnHours = 48;    ///< Refill warning lead
+  /** @} */
+
+  /**
+   * @name Scheduling
+   * @brief Watering windows and batching (see WateringWindow.h)
+   * @{
+   */
+  static constexpr uint8_t wateringBatchMin = 30;     ///< Default batch time
+  static constexpr uint16_t wateringMaxLateMin = 720; ///< Longest wait
+  /** @} */
+
+  /**
+   * @name Safety
+   * @brief Supervisor limits (see Supervisor.h)
+   * @{
+   */
+  static constexpr uint32_t pumpMaxRuntimeMs = 300000UL; ///< Continuous cap
+  static constexpr uint16_t screenTimeoutSeconds = 300;  ///< Menus, no input
+  static constexpr uint16_t manualTimeoutSeconds = 120;  ///< Manual watering
+  static constexpr uint32_t manualMaxHoldMs = 30000UL;   ///< One (M) hold
+  static constexpr uint16_t buttonReleaseTimeout = 2000; ///< Stuck button (ms)
+  /** @} */
+
+  /**
+   * @name Power
+   * @brief Low-power idle tuning and supply current figures for the power
+   * benchmark (board level, measured at the barrel jack)
+   * @{
+   */
+  static constexpr uint32_t backlightTimeout = 30000UL; ///< Dim after (ms)
+  static constexpr uint16_t wakeStartupMicros = 1024; ///< 16K CK at 16 MHz
+  static constexpr uint32_t activeCurrentUa = 46000UL; ///< Running, µA
+  static constexpr uint32_t sleepCurrentUa = 31000UL;  ///< Power-down, µA
+  /** @} */
+
+  /**
+   * @name Features
+   * @brief Optional hardware; code behind a false flag compiles out
+   * @{
+   */
+  static constexpr bool hasValve = true;            ///< Solenoid valve fitted
+  static constexpr bool hasWaterDetectProbe = true; ///< Spill probe fitted
+  static constexpr bool hasFloatSwitch = true;      ///< Tank float switch
+  static constexpr bool hasFlowMeter = false;       ///< Flow sensor fitted
+  static constexpr bool hasSoilComparator = false;  ///< Wake divider on AIN0
+  /** @} */
+};
+
+/**
+ * @brief Prototype 1.1: first perfboard build, same wiring as prototype 1
+ */
+struct HardwareRev11 : HardwareRev10 {};
+
+/**
+ * @brief Prototype 1.2: enclosed build, same wiring as prototype 1.1
+ */
+struct HardwareRev12 : HardwareRev11 {};
+
+/**
+ * @brief Prototype 1.3: prototype 1.2 plus a flow sensor in the outlet hose
+ */
+struct HardwareRev13 : HardwareRev12 {
+  static constexpr bool hasFlowMeter = true;
+};
+
+/**
+ * @brief Prototype 1.4: battery build of prototype 1.3. The DS1302 data line
+ * moves from D6 to A1 so that D6 (AIN0) can take a divider at soilWakeRaw,
+ * the reference for the soil wake (Power.h)
+ */
+struct HardwareRev14 : HardwareRev13 {
+  static constexpr uint8_t rtcDat = A1;
+  static constexpr bool hasSoilComparator = true;
+};
+
+#ifndef HW_REV
+#define HW_REV 12
+#endif
+
+#if HW_REV == 10
+typedef HardwareRev10 Hw;
+#elif HW_REV == 11
+typedef HardwareRev11 Hw;
+#elif HW_REV == 12
+typedef HardwareRev12 Hw;
+#elif HW_REV == 13
+typedef HardwareRev13 Hw;
+#elif HW_REV == 14
+typedef HardwareRev14 Hw;
+#else
+#error "Unknown HW_REV: expected 10, 11, 12, 13 or 14"
+#endif
+
+#endif
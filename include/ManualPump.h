@@ -0,0 +1,70 @@
+/**
+ * @file ManualPump.h
+ * @brief Pump switched straight from the (M) button edge in manual mode
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Manual mode used to poll (M) every ~75 ms and warm the spill probe
+ * for 200 ms on each press before starting the pump, so it started late and
+ * ran on after release. Now the button pin-change interrupt switches the pump
+ * (and valve) itself, within microseconds of the edge, as long as the screen
+ * has armed it: the screen keeps the safety sensors warm and re-checks them
+ * continuously, and the interrupt only adds a read of the float switch.
+ *
+ * The interrupt only touches the hardware. The screen notices the change on
+ * its next pass (about a millisecond) and does the bookkeeping (supervisor,
+ * telemetry, tank, event log), and it enforces Hw::manualMaxHoldMs.
+ *
+ * A stop forced by the screen (unsafe, hold too long, supervisor) latches:
+ * the pump stays off until (M) is released and pressed again.
+ *
+ * Edges within Hw::debounceDuration of a switch are contact bounce and are
+ * ignored, so a press or release moves the relay and motor once (and the heat
+ * model charges one start); manualPumpPoll() applies the settled level.
+ */
+
+#ifndef MANUAL_PUMP_H
+#define MANUAL_PUMP_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Hands (M) edges to the pump, disarmed
+ * @param pwm Duty the pump runs at
+ */
+void manualPumpBegin(uint8_t pwm);
+
+/**
+ * @brief Allows or forbids a press to start the pump
+ * @param safe Safety checks passed; false also stops a running pump
+ */
+void manualPumpArm(bool safe);
+
+/**
+ * @brief Applies the current (M) level; call every pass of the screen loop
+ * @details Catches an edge the interrupt could not act on (the host has no
+ * pin-change interrupt, and the pump is only armed between checks).
+ */
+void manualPumpPoll();
+
+/**
+ * @brief Whether the button has the pump on
+ */
+bool manualPumpOn();
+
+/**
+ * @brief millis() when the button last switched the pump
+ */
+unsigned long manualPumpChangedAt();
+
+/**
+ * @brief Stops the pump until (M) is released and pressed again
+ */
+void manualPumpStop();
+
+/**
+ * @brief Stops the pump and detaches from the button
+ */
+void manualPumpEnd();
+
+#endif
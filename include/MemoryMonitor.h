@@ -0,0 +1,54 @@
+/**
+ * @file MemoryMonitor.h
+ * @brief Stack high-water mark and heap fragmentation monitor
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details At reset (.init3, before constructors run) all SRAM between the end
+ * of .bss and the top of the stack is painted with a canary byte. The stack
+ * high-water mark is where the canary stops, scanning up from the heap top.
+ * Heap figures come from avr-libc's malloc state (__brkval and the free list).
+ *
+ * Shown on the Settings > Diagnostics LCD page and in the profiler dump.
+ */
+
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Snapshot of SRAM usage, all sizes in bytes
+ */
+struct MemoryStats {
+  uint16_t stackPeak;     ///< Deepest stack use since reset
+  uint16_t stackHeadroom; ///< Never-touched bytes between heap and stack
+  uint16_t freeNow;       ///< Gap between heap top and stack pointer now
+  uint16_t heapSize;      ///< Heap span from its start to __brkval
+  uint16_t heapFree;      ///< Bytes held on malloc's free list
+  uint16_t heapLargest;   ///< Largest single free-list block
+  uint8_t heapBlocks;     ///< Number of free-list blocks
+};
+
+/**
+ * @brief Scans SRAM and the malloc free list
+ * @param stats Filled with the current figures
+ * @details The canary scan walks the unused gap byte by byte (~1-2 KB), so
+ * call it from a diagnostics path, not every loop.
+ */
+void memoryStats(MemoryStats &stats);
+
+/**
+ * @brief Fragmentation of the heap's free space in percent
+ * @param stats Snapshot from memoryStats()
+ * @return 0 when all free heap is one block (or there is none), up to 100
+ */
+uint8_t memoryFragmentation(const MemoryStats &stats);
+
+/**
+ * @brief Prints a one-line memory report
+ * @param out Stream to print to
+ */
+void memoryReport(Print &out);
+
+#endif
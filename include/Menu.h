@@ -0,0 +1,174 @@
+/**
+ * @file Menu.h
+ * @brief Flash-resident menu descriptors and the engine that walks them
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Every settings screen used to be its own nested button loop. A menu
+ * is now a constexpr PROGMEM array of MenuItem, and menuPoll() is the single
+ * engine for all of them:
+ * - a menu of MENU_NUMBER items is a form: each value is edited with (-)/(+)
+ *   within [minValue, maxValue] by step, (M) stores it and calls apply, and
+ *   the menu is done after the last item
+ * - a menu of MENU_ACTION items is a list: (-)/(+) pick an entry, (M) closes
+ *   the menu and runs its apply
+ *
+ * A number may also take its limits from a MenuRange in RAM (set from the
+ * plant profile, say) and show its value as text, to pick from a list of
+ * names.
+ *
+ * (A) cancels either kind. Values already confirmed in a form stay stored.
+ * Holding (-)/(+) on a number repeats along menuRepeatCurve, timed from
+ * millis() on each poll.
+ *
+ * menuPoll() handles one key and returns; it never waits, so the caller keeps
+ * servicing between polls. While an animation owns the LCD the menu stays off
+ * it, a key skips the animation, and the menu redraws once it is gone.
+ *
+ * A new setting is one more item in a table:
+ * @code
+ * constexpr MenuItem dosingForm[] PROGMEM = {
+ *     {MENU_NUMBER, "How much water?", "Cups: ", 5, 100, 5, 1, &cups,
+ *      applyCups, nullptr, nullptr},
+ * };
+ * static_assert(menuValid(dosingForm), "bad dosing form");
+ * @endcode
+ */
+
+#ifndef MENU_H
+#define MENU_H
+
+#include <Arduino.h>
+
+#include "Display.h"
+
+/**
+ * @brief Kind of a menu item
+ */
+enum MenuItemType : uint8_t {
+  MENU_NUMBER, ///< Numeric field edited in place
+  MENU_ACTION, ///< List entry that runs apply when chosen
+};
+
+/**
+ * @brief Limits of a number known only at run time
+ * @details Narrows the item's own range, which stays the hard limit.
+ */
+struct MenuRange {
+  int16_t minValue;
+  int16_t maxValue;
+  int16_t step;
+};
+
+/**
+ * @brief One menu item, stored in flash (43 bytes on AVR)
+ */
+struct MenuItem {
+  MenuItemType type;
+  char text[17];    ///< Number: first-row title; action: list entry
+  char label[10];   ///< Number: second-row text before the value
+  int16_t minValue; ///< Number: smallest value
+  int16_t maxValue; ///< Number: largest value
+  int16_t step;     ///< Number: change per press
+  uint8_t decimals; ///< Number: value is shown divided by 10^decimals (0-2)
+  int16_t *value;   ///< Number: variable edited; read when the item opens
+  void (*apply)();  ///< Number: after (M) stored the value (may be nullptr);
+                    ///< action: run when chosen
+  const MenuRange *range; ///< Number: run-time limits (RAM, may be nullptr)
+  const char *(*valueText)(int16_t value); ///< Number: shows the value as text
+                                           ///< instead (may be nullptr)
+};
+
+/**
+ * @brief Key fed to menuPoll()
+ */
+enum MenuKey : uint8_t {
+  MENU_KEY_NONE,
+  MENU_KEY_MINUS, ///< (-)
+  MENU_KEY_PLUS,  ///< (+)
+  MENU_KEY_OK,    ///< (M)
+  MENU_KEY_BACK,  ///< (A)
+};
+
+/**
+ * @brief State of the open menu after a poll
+ */
+enum MenuResult : uint8_t {
+  MENU_RUNNING,   ///< Still open
+  MENU_DONE,      ///< Form confirmed, or list entry chosen (and run)
+  MENU_CANCELLED, ///< Closed with (A)
+};
+
+/**
+ * @brief One stage of the hold-to-repeat curve
+ */
+struct MenuRepeatStage {
+  uint16_t heldMs;   ///< Stage applies once the key is held this long
+  uint16_t periodMs; ///< Time from one step to the next
+  uint8_t steps;     ///< Steps moved per repeat
+};
+
+/**
+ * @brief Hold-to-repeat curve for (-)/(+) on numbers, by rising hold time
+ * @details The press moves one step at once. Held, it repeats after 400 ms,
+ * then every 150 ms, and ten steps at a time after 2.5 s.
+ */
+constexpr MenuRepeatStage menuRepeatCurve[] = {
+    {0, 400, 1},
+    {400, 150, 1},
+    {2500, 150, 10},
+};
+
+/**
+ * @brief Checks a menu table at compile time
+ * @details All items of one type; numbers with min <= max, a positive step
+ * and at most two decimals; actions with something to run.
+ */
+constexpr bool menuValid(const MenuItem *items, uint8_t count,
+                         MenuItemType type) {
+  return count == 0 ||
+         (items[0].type == type &&
+          (type == MENU_ACTION
+               ? items[0].apply != nullptr
+               : items[0].minValue <= items[0].maxValue &&
+                     items[0].step > 0 && items[0].decimals <= 2 &&
+                     items[0].value != nullptr) &&
+          menuValid(items + 1, count - 1, type));
+}
+
+template <uint8_t N> constexpr bool menuValid(const MenuItem (&items)[N]) {
+  return N != 0 && menuValid(items, N, items[0].type);
+}
+
+/**
+ * @brief Attaches the engine to the LCD
+ * @param display Display the menus are drawn on
+ */
+void menuBegin(Display &display);
+
+/**
+ * @brief Opens a menu, replacing any open one
+ * @param items PROGMEM item table
+ * @param count Number of items
+ * @param title First-row text of a list (RAM); unused by forms
+ */
+void menuOpen(const MenuItem *items, uint8_t count,
+              const char *title = nullptr);
+
+template <uint8_t N>
+void menuOpen(const MenuItem (&items)[N], const char *title = nullptr) {
+  menuOpen(items, N, title);
+}
+
+/**
+ * @brief Handles one key and redraws if needed
+ * @param key Key pressed since the last poll, or MENU_KEY_NONE
+ * @param held Whether the (-)/(+) key last pressed is still down
+ * @return MENU_RUNNING until the menu is confirmed or cancelled; MENU_DONE
+ * when no menu is open
+ * @details A chosen list entry runs after the menu has closed, so it may open
+ * menus of its own.
+ */
+MenuResult menuPoll(MenuKey key, bool held = false);
+
+#endif
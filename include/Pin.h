@@ -0,0 +1,106 @@
+/**
+ * @file Pin.h
+ * @brief Compile-time pin descriptors with direct port I/O
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details digitalWrite()/digitalRead() look up the port, bit mask and timer
+ * of a pin in PROGMEM tables on every call (~50 cycles). Pin<N> resolves the
+ * PINx/DDRx/PORTx I/O addresses and the bit mask at compile time, so each
+ * access compiles to a single sbi/cbi/sbis instruction on the ATmega328P.
+ *
+ * Pin<N> does not detach PWM the way digitalWrite() does; pins driven with
+ * analogWrite() (the pump) keep using the Arduino API.
+ *
+ * On the native build Pin<N> forwards to the host Arduino API so the same
+ * firmware code runs against the simulated board.
+ */
+
+#ifndef PIN_H
+#define PIN_H
+
+#include <Arduino.h>
+
+#if defined(__AVR_ATmega328P__)
+
+/**
+ * @brief I/O-space address of the PINx register for an Uno pin number
+ * @details D0-D7 are PORTD, D8-D13 are PORTB and A0-A5 (14-19) are PORTC.
+ * DDRx and PORTx follow PINx at +1 and +2.
+ */
+constexpr uint8_t pinInputRegister(uint8_t pin) {
+  return pin < 8 ? 0x09 : (pin < 14 ? 0x03 : 0x06);
+}
+
+/**
+ * @brief Bit of a pin within its port
+ */
+constexpr uint8_t pinBit(uint8_t pin) {
+  return pin < 8 ? pin : (pin < 14 ? pin - 8 : pin - 14);
+}
+
+/**
+ * @brief Zero-cost digital pin bound at compile time
+ * @tparam N Arduino Uno pin number (0-19)
+ */
+template <uint8_t N> struct Pin {
+  static_assert(N < 20, "Pin<N>: not an ATmega328P digital pin");
+
+  static constexpr uint8_t number = N;
+  static constexpr uint8_t mask = 1 << pinBit(N);
+
+  static inline void output() { _SFR_IO8(pinInputRegister(N) + 1) |= mask; }
+  static inline void input() {
+    _SFR_IO8(pinInputRegister(N) + 1) &= ~mask;
+    _SFR_IO8(pinInputRegister(N) + 2) &= ~mask;
+  }
+  static inline void inputPullup() {
+    _SFR_IO8(pinInputRegister(N) + 1) &= ~mask;
+    _SFR_IO8(pinInputRegister(N) + 2) |= mask;
+  }
+  static inline void high() { _SFR_IO8(pinInputRegister(N) + 2) |= mask; }
+  static inline void low() { _SFR_IO8(pinInputRegister(N) + 2) &= ~mask; }
+  static inline void write(bool value) {
+    if (value)
+      high();
+    else
+      low();
+  }
+  static inline bool read() { return _SFR_IO8(pinInputRegister(N)) & mask; }
+  static inline bool isLow() { return !read(); }
+};
+
+/**
+ * @brief Port read for a pin only known at run time
+ * @details Skips the timer/PWM bookkeeping of digitalRead(); still a pointer
+ * load rather than a single sbis, so prefer Pin<N> where N is a constant.
+ */
+inline bool readPin(uint8_t pin) {
+  return _SFR_IO8(pinInputRegister(pin)) & (1 << pinBit(pin));
+}
+
+#else
+
+/**
+ * @brief Host stub of Pin<N> for the native build
+ * @details Routes through the host Arduino API so the simulated board sees
+ * the same pin traffic as the firmware.
+ */
+template <uint8_t N> struct Pin {
+  static constexpr uint8_t number = N;
+
+  static inline void output() { pinMode(N, OUTPUT); }
+  static inline void input() { pinMode(N, INPUT); }
+  static inline void inputPullup() { pinMode(N, INPUT_PULLUP); }
+  static inline void high() { digitalWrite(N, HIGH); }
+  static inline void low() { digitalWrite(N, LOW); }
+  static inline void write(bool value) { digitalWrite(N, value ? HIGH : LOW); }
+  static inline bool read() { return digitalRead(N) == HIGH; }
+  static inline bool isLow() { return !read(); }
+};
+
+inline bool readPin(uint8_t pin) { return digitalRead(pin) == HIGH; }
+
+#endif
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @file PlantProfile.h
+ * @brief Library of watering profiles for common plants
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details The wet cut-off (70%), the dose range (0.5-10 cups) and the
+ * interval step (60 min) used to be fixed for every plant. They now come from
+ * the profile chosen under Settings → Plant Profile (or `s pp` over Serial),
+ * one per unit. A profile gives:
+ * - a target moisture band: watering is skipped at or above the top of it,
+ *   and in auto mode soil that dries below the bottom is watered early
+ * - the largest dose a single watering may give
+ * - the minimum spacing between waterings, also the step of the auto-mode
+ *   interval
+ * - the hours of the day an early watering may start
+ *
+ * The library stays in flash. plantSelect() resolves the chosen profile once
+ * into the RAM struct plant, with the band already converted to raw probe
+ * counts, so the checks on every pass are plain comparisons against the soil
+ * sampler's raw reading.
+ */
+
+#ifndef PLANT_PROFILE_H
+#define PLANT_PROFILE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Hours h with from <= h < to, as a bit mask (bit h = hour h)
+ */
+constexpr uint32_t plantHours(uint8_t from, uint8_t to) {
+  return from >= to ? 0 : (1UL << from) | plantHours(from + 1, to);
+}
+
+/**
+ * @brief One library entry, stored in flash (27 bytes on AVR)
+ */
+struct PlantProfile {
+  char name[17];           ///< Shown on the LCD
+  uint8_t moistureLow;     ///< Band bottom (%); 0 = schedule only
+  uint8_t moistureHigh;    ///< Band top (%): too wet to water
+  uint16_t maxDoseMl;      ///< Largest single dose
+  uint16_t minSpacingMin;  ///< Shortest time between waterings
+  uint32_t preferredHours; ///< plantHours() an early watering may start in
+};
+
+/**
+ * @brief The selected profile, resolved for the hot checks
+ */
+struct ActivePlant {
+  uint16_t dryRaw;            ///< Probe below this: dry enough to water early
+  uint16_t wetRaw;            ///< Probe at or above this: too wet to water
+  uint16_t maxDoseMl;         ///< Largest single dose
+  unsigned long minSpacingMs; ///< Shortest time between waterings
+  uint32_t preferredHours;    ///< Bit h: an early watering may start at hour h
+  uint16_t minSpacingMin;     ///< minSpacingMs in minutes, for the settings
+  uint8_t wetPercent;         ///< wetRaw as a percentage, for the settings
+  uint8_t index;              ///< Library entry
+};
+
+const uint8_t plantProfileCount = 6; ///< Entries in the library
+
+/**
+ * @brief Longest auto-mode interval any profile allows (minutes, 1 week)
+ */
+const uint16_t plantMaxIntervalMin = 10080;
+
+extern ActivePlant plant; ///< Resolved profile; change with plantSelect()
+
+/**
+ * @brief Makes a library entry the active profile
+ * @param index Entry, below plantProfileCount (others select entry 0)
+ */
+void plantSelect(uint8_t index);
+
+/**
+ * @brief Overrides the top of the band for the active profile
+ * @param percent Moisture (%) at which watering is skipped
+ * @details Lasts until the next plantSelect().
+ */
+void plantSetWetPercent(uint8_t percent);
+
+/**
+ * @brief Name of a library entry
+ * @param index Entry, below plantProfileCount
+ * @return Copy in RAM, valid until the next call
+ */
+const char *plantName(uint8_t index);
+
+/**
+ * @brief Whether an early watering may start at this hour of the day
+ * @param hour RTC hour (0-23)
+ */
+inline bool plantPrefersHour(uint8_t hour) {
+  return (plant.preferredHours >> hour) & 1;
+}
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @file Power.h
+ * @brief Low-power idle between main loop ticks
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Two levels of idle:
+ * - powerSleep(): power-down sleep timed by the watchdog, woken early by a
+ *   button or RX pin change. millis() is credited with the slept time, using
+ *   a watchdog period calibrated against the crystal at boot.
+ * - powerNap(): idle sleep until the next interrupt (at most one Timer0
+ *   overflow, ~1 ms). Replaces busy-waiting in menu polling loops.
+ *
+ * On boards with Hw::hasSoilComparator, powerSleep() can also watch the soil
+ * probe: the analog comparator compares the soil channel (through the ADC
+ * mux, ADC off) against the divider on AIN0 and flags the reading falling
+ * below Hw::soilWakeRaw. In idle sleep (Serial kept awake) its interrupt ends
+ * the sleep at once. The comparator cannot wake power-down, so there its
+ * output is checked on the watchdog wake instead, which is still no ADC
+ * conversion and no probe warm-up. The divider is fixed, so the wake does
+ * not follow the plant profile's dry mark; SoilSampler.h lists what it
+ * covers per profile. A reference filtered from PWM on D6 could follow the
+ * profile, but Timer0 stops in power-down.
+ *
+ * The USART is stopped in power-down, so the start bit of the byte that wakes
+ * the controller is all it sees of that byte: the byte is lost (the next one
+ * may arrive garbled while the oscillator starts). Keeping the USART running
+ * instead would mean idle sleep all the time, several mA rather than a few
+ * µA. So after any Serial input powerSleep() only idles, for 30 s, and a
+ * terminal wakes a sleeping unit with an empty line before its command; a
+ * command sent straight away may come back as ERR and needs sending again.
+ *
+ * Timer2 cannot wake the ATmega328P from power-save on the Uno because there
+ * is no 32 kHz crystal on TOSC1/2, so the watchdog is the timed wake source.
+ *
+ * Build with -DPOWER_BENCHMARK to report awake/asleep time, estimated average
+ * supply current and wake latency over Serial.
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Configures button pin-change wake and calibrates the watchdog
+ * @details Costs ~32 ms at boot: two watchdog periods are timed with micros()
+ */
+void powerBegin();
+
+/**
+ * @brief Sleeps in power-down for up to maxMs milliseconds
+ * @param maxMs Longest time to sleep; rounded down to a watchdog period
+ * @details Returns immediately (after a nap) if a button is held or maxMs is
+ * shorter than the smallest watchdog period (16 ms).
+ */
+void powerSleep(unsigned long maxMs);
+
+/**
+ * @brief Keeps the USART able to receive while idle
+ * @param enabled true to sleep in idle mode only, so Serial input is never
+ * lost and a received byte ends the sleep early; false keeps the RX wake
+ */
+void powerKeepSerialAwake(bool enabled);
+
+/**
+ * @brief Idles the CPU until the next interrupt
+ */
+void powerNap();
+
+/**
+ * @brief Reports whether a button woke the last powerSleep()
+ * @return true once per button wake, then false until the next one
+ */
+bool powerWokeByButton();
+
+/**
+ * @brief Has the following powerSleep() calls watch the soil probe
+ * @param enabled true to arm the comparator while asleep; ignored without
+ * Hw::hasSoilComparator. The probe must be powered.
+ */
+void powerSoilWake(bool enabled);
+
+/**
+ * @brief Reports whether the soil fell below Hw::soilWakeRaw in the last
+ * powerSleep()
+ * @return true once per crossing, then false until the next one
+ */
+bool powerWokeBySoil();
+
+/**
+ * @brief Runs a function from the button pin-change interrupt
+ * @param hook Called on every button edge (keep it short), or nullptr
+ * @details Board builds only; the host has no pin-change interrupt.
+ */
+void powerButtonHook(void (*hook)());
+
+/**
+ * @brief Prints the power benchmark counters (POWER_BENCHMARK builds)
+ * @param out Stream to print to
+ */
+void powerReport(Print &out);
+
+#endif
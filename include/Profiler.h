@@ -0,0 +1,77 @@
+/**
+ * @file Profiler.h
+ * @brief Section timing histograms and max blocking time over Serial
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Build with -DPROFILING (env:uno_profile) to time named sections of
+ * the firmware. Each section keeps a log2 latency histogram and its longest
+ * run, 16 bytes of RAM per section. Send 'p' over Serial to dump them (plus
+ * the MemoryMonitor stack/heap line) and 'r' to reset; both are verbs of the
+ * Serial command protocol (SerialCommand.h).
+ *
+ * Timestamps come from Timer0 (micros(), 4 µs = 64 cycles at 16 MHz). Timer1
+ * would give single-cycle resolution but it drives the pump PWM on pin 10.
+ *
+ * Without PROFILING every macro expands to nothing.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Named sections that can be timed
+ */
+enum ProfileSection {
+  PROFILE_LOOP,  ///< One main-menu loop() tick (excluding idle sleep)
+  PROFILE_MENU,  ///< One handleMenu() call, start to return
+  PROFILE_WATER, ///< waterPlant() valve/pump delay chain
+  PROFILE_PROBE, ///< isPlantOkayToWater() sensor warm-up chain
+  PROFILE_SECTIONS
+};
+
+#ifdef PROFILING
+
+/**
+ * @brief Adds one timed run to a section
+ * @param section Section the run belongs to
+ * @param micros Run time in microseconds
+ */
+void profileRecord(ProfileSection section, unsigned long micros);
+
+/**
+ * @brief Prints every section's histogram and maximum, then memory usage
+ * @param out Stream to print to
+ */
+void profileDump(Print &out);
+
+/**
+ * @brief Clears all histograms and maxima
+ */
+void profileReset();
+
+/**
+ * @brief RAII timer that records its lifetime into a section
+ */
+class ProfileScope {
+public:
+  explicit ProfileScope(ProfileSection section)
+      : section_(section), start_(micros()) {}
+  ~ProfileScope() { profileRecord(section_, micros() - start_); }
+
+private:
+  ProfileSection section_;
+  unsigned long start_;
+};
+
+#define PROFILE_SCOPE(section) ProfileScope profileScope(section)
+
+#else
+
+#define PROFILE_SCOPE(section)
+
+#endif
+
+#endif
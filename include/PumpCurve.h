@@ -0,0 +1,105 @@
+/**
+ * @file PumpCurve.h
+ * @brief Multi-point pump calibration and dose planning
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Two small piecewise-linear tables, filled by calibration runs:
+ * - Time curve: (run time, volume) at full PWM. Captures priming and head
+ *   pressure, which make volume non-linear in time for short runs. The origin
+ *   is implied; beyond the last point the last segment is extended.
+ * - Flow curve: (PWM, average flow) per run, so each point includes priming
+ *   at that speed. Every full-speed run adds a point here as well.
+ *
+ * pumpCurvePlan() turns a volume into a PWM and run time: small doses run at
+ * the PWM whose flow stretches them to at least Hw::pumpMinDoseMs (timing
+ * error is then a small fraction of the dose), everything else at full speed
+ * from the time curve.
+ */
+
+#ifndef PUMP_CURVE_H
+#define PUMP_CURVE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Points kept per curve; a new point replaces the nearest when full
+ */
+const uint8_t pumpCurveMaxPoints = 4;
+
+/**
+ * @brief One calibration point
+ * @details x is the run time (ms) on the time curve and the PWM duty on the
+ * flow curve; y is the volume (ml) or the flow (ml/min).
+ */
+struct PumpCurvePoint {
+  uint32_t x;
+  uint16_t y;
+};
+
+/**
+ * @brief Which table a point belongs to
+ */
+enum PumpCurveKind : uint8_t {
+  PUMP_CURVE_TIME, ///< Full-speed run time (ms) to volume (ml)
+  PUMP_CURVE_FLOW, ///< PWM duty to flow (ml/min)
+};
+
+/**
+ * @brief A planned pump run
+ */
+struct PumpPlan {
+  uint8_t pwm;             ///< Duty to run the pump at
+  unsigned long durationMs; ///< How long to run it
+};
+
+/**
+ * @brief Removes every point from one curve
+ */
+void pumpCurveClear(PumpCurveKind kind);
+
+/**
+ * @brief Adds (or replaces) a calibration point, keeping x sorted
+ * @param kind Curve to add to
+ * @param x Run time (ms) or PWM duty
+ * @param y Volume (ml) or flow (ml/min); must be non-zero
+ * @return false if the point was rejected
+ * @details y must increase with x across the curve (more time, more volume;
+ * more duty, more flow). A point that breaks this against any point it does
+ * not replace is rejected, so the planner never interpolates backwards.
+ */
+bool pumpCurveAdd(PumpCurveKind kind, uint32_t x, uint16_t y);
+
+/**
+ * @brief Number of points on a curve
+ */
+uint8_t pumpCurveSize(PumpCurveKind kind);
+
+/**
+ * @brief Reads a point (in x order)
+ */
+PumpCurvePoint pumpCurvePoint(PumpCurveKind kind, uint8_t index);
+
+/**
+ * @brief Full-speed run time for a volume from the time curve
+ * @return Milliseconds, or 0 if the time curve is empty
+ */
+unsigned long pumpCurveDuration(uint16_t volumeMl);
+
+/**
+ * @brief Estimates the volume a run delivered
+ * @param pwm Duty the pump ran at
+ * @param durationMs How long it ran
+ * @return Millilitres, or 0 if the curves cannot tell
+ */
+uint16_t pumpCurveVolume(uint8_t pwm, unsigned long durationMs);
+
+/**
+ * @brief Chooses PWM and run time for a dose
+ * @param volumeMl Dose to deliver
+ * @param plan Filled in when the curves allow a plan
+ * @return false (plan untouched) if the curves hold no usable points
+ */
+bool pumpCurvePlan(uint16_t volumeMl, PumpPlan &plan);
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file PumpDrive.h
+ * @brief Pump PWM with a soft-start ramp, and a thermal budget for the motor
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Every start used to switch the pump from 0 straight to its duty,
+ * and nothing limited how long or how often it ran. All pump output now goes
+ * through here:
+ * - a start ramps the duty along pumpRampCurve; the ramp is stepped from the
+ *   Timer1 overflow interrupt (every ~2 ms, the pump pin's own PWM timer), so
+ *   nothing waits for it. The host build steps it from pumpDriveService().
+ *   Calibration runs ramp too, so the curve already accounts for it.
+ * - a stop is immediate
+ * - pump heat is modelled from the duty history: it builds up with on-time
+ *   (in ms at full duty), plus Hw::pumpStartHeatMs per start, and cools off
+ *   exponentially with Hw::pumpThermalTauS. Hw::pumpHeatBudgetMs is as much
+ *   as the motor may hold.
+ *
+ * Callers plan with pumpHeatHeadroomMs() and pumpCoolDownMs(): auto mode
+ * splits a dose that would overrun the budget and waits for the pump to cool
+ * before the rest, and manual mode disarms (M) when the budget is used up.
+ */
+
+#ifndef PUMP_DRIVE_H
+#define PUMP_DRIVE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief One point of the start ramp
+ */
+struct PumpRampPoint {
+  uint16_t atMs;   ///< Time since the start
+  uint8_t percent; ///< Duty at that time, % of the requested duty
+};
+
+/**
+ * @brief Soft-start ramp, linear between points by rising time
+ * @details A third of the duty at once, which is enough to get the impeller
+ * turning, then up to the full duty in 400 ms.
+ */
+constexpr PumpRampPoint pumpRampCurve[] = {
+    {0, 35},
+    {120, 60},
+    {400, 100},
+};
+
+/**
+ * @brief Configures the ramp timer; pump off
+ */
+void pumpDriveBegin();
+
+/**
+ * @brief Sets the pump duty
+ * @param pwm Duty (0-255); 0 stops at once
+ * @details From standstill the duty ramps up; while running it changes at
+ * once. Safe to call from an interrupt.
+ */
+void pumpDriveSet(uint8_t pwm);
+
+/**
+ * @brief Stops the pump at once (pumpDriveSet(0)); safe from any interrupt
+ */
+void pumpDriveStop();
+
+/**
+ * @brief Duty on the pin right now
+ */
+uint8_t pumpDriveDuty();
+
+/**
+ * @brief Updates the thermal model (and the host ramp); call from every tick
+ */
+void pumpDriveService();
+
+/**
+ * @brief How long the pump may run at a duty before using up its budget
+ * @param pwm Duty of the run
+ * @return Milliseconds, 0 when it must cool first; includes the start's heat
+ * when the pump is off
+ */
+unsigned long pumpHeatHeadroomMs(uint8_t pwm);
+
+/**
+ * @brief Time for the pump to cool enough for a run
+ * @param runMs Length of the run
+ * @param pwm Duty of the run
+ * @return Milliseconds from now, 0 if it fits already. For a run too long to
+ * fit even a cold pump, the wait ends when the heat is down to a quarter of
+ * the budget.
+ */
+unsigned long pumpCoolDownMs(unsigned long runMs, uint8_t pwm);
+
+/**
+ * @brief Pump heat as a share of the budget (%)
+ */
+uint8_t pumpHeatPercent();
+
+#endif
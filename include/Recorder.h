@@ -0,0 +1,109 @@
+/**
+ * @file Recorder.h
+ * @brief Timestamped input trace for record/replay, streamed as telemetry
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Build with -DRECORDING (env:uno_record) to log every input the
+ * firmware acts on: button, M-hold and float switch levels, the soil and spill
+ * probe ADC readings, the RTC and Serial RX bytes. Events are packed into
+ * TELEMETRY_TRACE records and go out with the rest of the telemetry, so a
+ * plain Serial capture holds the whole trace. tools/telemetry_decode.py
+ * --trace extracts it and env:native_replay feeds it back through the native
+ * HAL (sim/replay.cpp).
+ *
+ * Each event is one tag byte, kind << 6 | level << 5 | pin, a varint of the
+ * milliseconds since the previous event in the record (the first one counts
+ * from TelemetryTrace::startMs), then a payload:
+ * - TRACE_PIN: none, the level is in the tag; recorded on change only
+ * - TRACE_ANALOG: uint16 reading; every read
+ * - TRACE_RTC: int32 RTC seconds minus millis() / 1000; recorded when that
+ *   offset moves by more than a second (clock set, drift), so reading the
+ *   clock every frame costs nothing
+ * - TRACE_SERIAL: the byte
+ *
+ * A record is flushed when full or recordFlushMs after its first event. If the
+ * telemetry ring has no room it is kept and retried; events that arrive while
+ * it is full are dropped and counted. Every record carries the count so far
+ * (TelemetryTrace::lost); where it rises the decoder writes a "# lost" line
+ * into the trace and replay reports the gap.
+ *
+ * Flow meter pulses are counted in an ISR and are not recorded, so a metered
+ * run (flow meter fitted, dose set by volume) is not reproducible: in replay
+ * the synthetic meter decides when it reaches its volume, stalls or times
+ * out, and the pump records that follow may differ from the board's.
+ *
+ * Without RECORDING every macro expands to nothing and its arguments are not
+ * evaluated.
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Event kinds (top two bits of the tag byte)
+ */
+enum TraceKind : uint8_t {
+  TRACE_PIN = 0,    ///< Digital input level changed
+  TRACE_ANALOG = 1, ///< ADC reading
+  TRACE_RTC = 2,    ///< RTC offset against millis()
+  TRACE_SERIAL = 3, ///< Serial RX byte
+};
+
+#ifdef RECORDING
+
+/**
+ * @brief Records a digital input read; only changes are kept
+ * @param pin Arduino pin number (0-31)
+ * @param level Level read (HIGH/true or LOW/false)
+ */
+void recordPin(uint8_t pin, bool level);
+
+/**
+ * @brief Records an ADC reading
+ * @param pin Arduino pin number of the analog input
+ * @param value Reading (0-1023)
+ */
+void recordAnalog(uint8_t pin, uint16_t value);
+
+/**
+ * @brief Records an RTC read if it moved against millis()
+ * @param seconds RtcDateTime::TotalSeconds() of the reading
+ */
+void recordRtc(uint32_t seconds);
+
+/**
+ * @brief Records one Serial RX byte
+ * @param data Byte read
+ */
+void recordSerial(uint8_t data);
+
+/**
+ * @brief Flushes the pending record once it is full or old enough
+ */
+void recordService();
+
+/**
+ * @brief Number of events dropped because no record was free
+ */
+uint16_t recordLost();
+
+#define RECORD_PIN(pin, level) recordPin(pin, level)
+#define RECORD_ANALOG(pin, value) recordAnalog(pin, value)
+#define RECORD_RTC(seconds) recordRtc(seconds)
+#define RECORD_SERIAL(data) recordSerial(data)
+#define RECORD_SERVICE() recordService()
+
+#else
+
+#define RECORD_PIN(pin, level)
+#define RECORD_ANALOG(pin, value)
+#define RECORD_RTC(seconds)
+#define RECORD_SERIAL(data)
+#define RECORD_SERVICE()
+
+#endif
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file SerialCommand.h
+ * @brief Incremental parser for the text command protocol on Serial
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details One command per line, tokens separated by spaces:
+ *
+ *     <verb> [<key>] [<int> ...]
+ *
+ * The verb is a single letter and the key up to two lowercase letters, e.g.
+ * `g iv`, `s iv 90`, `s rt 2025 6 1 14 30 0`, `w`, `x`. Key and numbers are
+ * optional; what they mean is up to the caller.
+ *
+ * HardwareSerial keeps its RX ring private, so the parser consumes it one
+ * byte at a time and folds each byte straight into the decoded command:
+ * there is no line buffer, a call does only as much work as there are bytes
+ * waiting, and it returns as soon as a line completes so the rest stays in
+ * the RX ring for the next call. Malformed lines are reported once and the
+ * remainder of the line is skipped.
+ */
+
+#ifndef SERIAL_COMMAND_H
+#define SERIAL_COMMAND_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Most numeric arguments a command can carry
+ */
+const uint8_t commandMaxArgs = 6;
+
+/**
+ * @brief Packs a two-letter key the way the parser stores it
+ * @param first First letter
+ * @param second Second letter (0 for one-letter keys)
+ */
+constexpr uint16_t commandKey(char first, char second) {
+  return (static_cast<uint16_t>(first) << 8) | static_cast<uint8_t>(second);
+}
+
+/**
+ * @brief A decoded command line
+ */
+struct SerialCommand {
+  char verb;               ///< First letter of the line
+  uint16_t key;            ///< commandKey() of the second token, 0 if none
+  uint8_t argc;            ///< Numeric arguments that followed
+  long argv[commandMaxArgs]; ///< Argument values
+  bool error;              ///< Line was malformed; other fields are invalid
+};
+
+/**
+ * @brief Consumes waiting Serial bytes until a line completes
+ * @param command Filled in when a line completes
+ * @return true when a line (valid or not) completed; check command.error
+ */
+bool commandPoll(SerialCommand &command);
+
+/**
+ * @brief Ends a reply line
+ * @details Replies share the port with the binary telemetry stream, so each
+ * one is closed with the 0x00 frame delimiter as well as a newline. The
+ * decoder then sees the text as a frame of its own instead of letting it
+ * corrupt the next telemetry record.
+ */
+void commandEndReply();
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @file SoilSampler.h
+ * @brief Soil probe sampling paced by how fast the reading moves
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details The probe used to be read only on demand (M on the clock screen,
+ * or a watering check) through a fixed 1 s cache, so the clock showed
+ * whatever the last check left behind. soilService() now samples it in the
+ * background:
+ * - every 2 s while the pump runs and for 10 min after it stops, while the
+ *   water soaks in
+ * - otherwise from 5 s, doubling after each sample that moved less than
+ *   soilChangeCounts, up to 15 min
+ * - back to 5 s as soon as a sample moves by soilChangeCounts or more
+ * - on boards with Hw::hasSoilComparator, while the soil reads at or above
+ *   Hw::soilWakeRaw: as above, and in between the probe stays powered for the
+ *   comparator (Power.h), which wakes the controller for a full sample once
+ *   the soil dries past the reference. A watch lasts a quarter of the
+ *   sampling period after each sample, at most soilWatchMaxMs, then the
+ *   probe is switched off until the next timed sample. A powered probe draws
+ *   its divider current the whole time and wears its electrodes, so it is
+ *   never left on for good.
+ *
+ * The comparator reference is the fixed divider at Hw::soilWakeRaw (415,
+ * about 20%), not the profile's dry mark (plant.dryRaw), and it only listens
+ * during a watch. It therefore bounds the timed sampling for one crossing,
+ * near 20%, and nothing more. The profile's own early-watering mark is always
+ * found by a timed sample, up to one sampling period (15 min) late, or about
+ * 13 min after a 2 min watch has ended:
+ * - Generic: no dry mark (schedule only); the comparator adds nothing
+ * - Succulent (10%, raw 358): the wake at 20% brings a sample forward, but
+ *   the 10% mark itself is found by the timed samples that follow
+ * - Herbs (35%, 503), Tomato/Pepper (45%, 561), Seedlings (50%, 590), Fern
+ *   (55%, 619): the mark is passed before the comparator trips; timed
+ *   samples only
+ *
+ * The probe is powered for soilWarmMs before each background read without
+ * blocking: the read happens on a later service tick. Readings carry their
+ * age, so each consumer decides how fresh it needs them (soilRead()).
+ */
+
+#ifndef SOIL_SAMPLER_H
+#define SOIL_SAMPLER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief A probe reading and how old it is
+ */
+struct SoilSample {
+  uint16_t raw;        ///< ADC reading (0-1023), higher is wetter
+  unsigned long ageMs; ///< Time since it was taken
+};
+
+/**
+ * @name Sampling Limits
+ * @{
+ */
+const uint8_t soilWarmMs = 10;        ///< Probe supply on before a read
+const uint8_t soilChangeCounts = 12;  ///< Move that counts as a change (~2%)
+const unsigned long soilWatchMaxMs = 120000UL; ///< Longest comparator watch
+/** @} */
+
+/**
+ * @brief Configures the probe supply and takes the first reading
+ */
+void soilBegin();
+
+/**
+ * @brief Takes a background sample when one is due; call from every tick
+ */
+void soilService();
+
+/**
+ * @brief Latest reading, without touching the probe
+ */
+SoilSample soilLatest();
+
+/**
+ * @brief A reading no older than maxAgeMs
+ * @param maxAgeMs Oldest acceptable reading; 0 always reads the probe
+ * @details Reads the probe (blocking soilWarmMs) only if the latest reading
+ * is too old.
+ */
+SoilSample soilRead(unsigned long maxAgeMs);
+
+/**
+ * @brief Tells the sampler the pump started or stopped
+ * @param running Pump on
+ */
+void soilWatering(bool running);
+
+/**
+ * @brief Milliseconds until soilService() next has work
+ */
+unsigned long soilDueIn();
+
+/**
+ * @brief Whether the probe is left to the comparator wake between timed
+ * samples (powered, warm and within the watch window)
+ */
+bool soilWatching();
+
+#endif
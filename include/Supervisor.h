@@ -0,0 +1,109 @@
+/**
+ * @file Supervisor.h
+ * @brief Safety supervisor: hardware watchdog, pump runtime cap and screen
+ * deadlines
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details While awake the AVR watchdog runs in interrupt-then-reset mode
+ * with an 8 s period, and supervisorPoll() is the only place that feeds it.
+ * supervisorPoll() runs from the service dispatcher that every screen's
+ * polling loop goes through, and it feeds only once its checks have run:
+ * - pump on longer than Hw::pumpMaxRuntimeMs, or with the tank low: fault
+ * - no user input on a screen for longer than its deadline: the screen is
+ *   asked to exit (supervisorExitRequested() acts as a press of (A)); this
+ *   is routine, not a fault, and leaves the record and outputs alone
+ *
+ * On any fault the pump PWM is zeroed and the valve closed first. A hang
+ * that stops the dispatcher lets the watchdog interrupt fire: it does the
+ * same, records the fault in RAM that survives the reset, and resets.
+ * Power-down sleep borrows the watchdog for timing and hands it back with
+ * supervisorWatchdogResume().
+ *
+ * Build with -DFAULT_INJECTION to add the `f <fault>` Serial command that
+ * triggers each fault path on purpose.
+ */
+
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Fault codes, as recorded and reported
+ */
+enum SupervisorFault : uint8_t {
+  FAULT_NONE = 0,
+  FAULT_WATCHDOG = 1,       ///< Dispatcher stopped running (hang)
+  FAULT_PUMP_RUNTIME = 2,   ///< Pump exceeded its continuous runtime cap
+  FAULT_PUMP_DRY = 3,       ///< Pump running while the tank reads low
+};
+
+/**
+ * @brief Reads the fault record and arms the watchdog
+ * @return FAULT_WATCHDOG if the last run ended in a watchdog reset
+ * @details Call once, after powerBegin().
+ */
+SupervisorFault supervisorBegin();
+
+/**
+ * @brief Runs the checks and feeds the watchdog; call from the dispatcher
+ * @param pumpOn Pump currently running
+ * @param hasWater Tank reads water
+ * @return The fault raised by this call, or FAULT_NONE
+ */
+SupervisorFault supervisorPoll(bool pumpOn, bool hasWater);
+
+/**
+ * @brief Notes that the pump was switched on or off (starts the runtime cap)
+ */
+void supervisorPumpChanged(bool on);
+
+/**
+ * @brief Sets the inactivity deadline of the screen being entered
+ * @param seconds Deadline, 0 for none
+ */
+void supervisorScreen(uint16_t seconds);
+
+/**
+ * @brief Clears the screen deadline and any pending exit request
+ */
+void supervisorLeaveScreen();
+
+/**
+ * @brief Notes user input (restarts the screen deadline)
+ */
+void supervisorActivity();
+
+/**
+ * @brief Reports whether the current screen must exit
+ */
+bool supervisorExitRequested();
+
+/**
+ * @brief Forces the pump off and the valve closed, then records the fault
+ * @param fault Why
+ */
+void supervisorFault(SupervisorFault fault);
+
+/**
+ * @brief Last fault recorded since boot
+ */
+SupervisorFault supervisorLastFault();
+
+/**
+ * @brief Faults recorded since power-on (survives watchdog resets)
+ */
+uint8_t supervisorFaultCount();
+
+/**
+ * @brief Re-arms the supervisor watchdog after power-down sleep used it
+ */
+void supervisorWatchdogResume();
+
+/**
+ * @brief Watchdog interrupt handler body: safe outputs, record, reset
+ */
+void supervisorWatchdogExpired();
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file TankModel.h
+ * @brief Reservoir volume estimate and refill prediction
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details The float switch only says whether the level is above its mark.
+ * The model integrates every dispensed volume against Hw::tankCapacityMl and
+ * snaps to what the switch proves:
+ * - switch trips (water -> low): exactly Hw::tankLowMarkMl is left
+ * - switch clears (low -> water): the tank was refilled, assume full
+ * - otherwise the estimate is clamped to the side of the mark the switch is on
+ *
+ * Water sloshing near the mark, during or just after a run, toggles the
+ * switch for a few seconds, and a refill makes it chatter on the way up. So
+ * the model only acts on a switch state that has held for tankSettleMs; the
+ * supervisor's dry-run cut-off still reads the switch directly.
+ *
+ * From the daily use implied by the schedule it predicts how long until the
+ * switch trips, so a refill can be asked for ahead of time.
+ */
+
+#ifndef TANK_MODEL_H
+#define TANK_MODEL_H
+
+#include <Arduino.h>
+
+/**
+ * @brief No prediction (nothing scheduled)
+ */
+const uint16_t tankNoPrediction = 0xFFFF;
+
+/**
+ * @brief How long the float switch must hold a new state to be believed
+ */
+const unsigned long tankSettleMs = 10000UL;
+
+/**
+ * @brief Starts the estimate from the switch state at boot
+ * @param hasWater Float switch reads water
+ */
+void tankBegin(bool hasWater);
+
+/**
+ * @brief Reconciles the estimate with the float switch; call often
+ * @param hasWater Float switch reads water
+ */
+void tankUpdate(bool hasWater);
+
+/**
+ * @brief Float switch state once it has held for tankSettleMs
+ */
+bool tankHasWater();
+
+/**
+ * @brief Subtracts a dispensed volume
+ */
+void tankDispensed(uint16_t volumeMl);
+
+/**
+ * @brief Estimated volume left in the tank
+ */
+uint16_t tankRemainingMl();
+
+/**
+ * @brief Overrides the estimate (e.g. after a partial refill)
+ */
+void tankSetRemaining(uint16_t volumeMl);
+
+/**
+ * @brief Hours until the float switch is expected to trip
+ * @param dailyUseMl Volume the schedule dispenses per day
+ * @return Hours (0 when already low), or tankNoPrediction
+ */
+uint16_t tankHoursToLow(unsigned long dailyUseMl);
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @file Telemetry.h
+ * @brief Framed binary telemetry over Serial (COBS + CRC-16)
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Each record is a fixed little-endian struct followed by a
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) of the record bytes. The
+ * record and CRC are COBS-encoded and terminated by 0x00, so a receiver can
+ * resynchronise on any zero byte and drop frames whose CRC fails (e.g. the
+ * ASCII lines printed by the profiler).
+ *
+ * Frames are queued in a RAM ring and moved into the Serial TX buffer only as
+ * space allows, so sending never blocks the control loop. A frame that does
+ * not fit in the ring is dropped whole and counted.
+ *
+ * tools/telemetry_decode.py turns a captured stream into CSV. Keep it in step
+ * with the record layouts below.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Record type tags (first byte of every record)
+ */
+enum TelemetryType : uint8_t {
+  TELEMETRY_STATUS = 1, ///< Periodic sensor and schedule snapshot
+  TELEMETRY_PUMP = 2,   ///< Pump switched on or off
+  TELEMETRY_LCD = 3,    ///< One row of the LCD frame (Serial mirror)
+  TELEMETRY_FAULT = 4,  ///< Safety supervisor fault
+  TELEMETRY_TRACE = 5,  ///< Recorded inputs (RECORDING builds, Recorder.h)
+};
+
+/**
+ * @name Status Flags
+ * @brief Bits of TelemetryStatus::flags
+ * @{
+ */
+const uint8_t TELEMETRY_FLAG_PUMP = 0x01;      ///< Pump running
+const uint8_t TELEMETRY_FLAG_VALVE = 0x02;     ///< Valve open
+const uint8_t TELEMETRY_FLAG_AUTO = 0x04;      ///< Auto mode enabled
+const uint8_t TELEMETRY_FLAG_TANK_OK = 0x08;   ///< Float switch sees water
+const uint8_t TELEMETRY_FLAG_BACKLIGHT = 0x10; ///< LCD backlight on
+const uint8_t TELEMETRY_FLAG_DEFERRED = 0x20;  ///< Watering waits for a window
+/** @} */
+
+/**
+ * @brief Why the pump changed state
+ */
+enum TelemetryPumpReason : uint8_t {
+  PUMP_REASON_MANUAL = 0,      ///< Manual mode (M held)
+  PUMP_REASON_SCHEDULE = 1,    ///< Auto-mode scheduled watering
+  PUMP_REASON_CALIBRATION = 2, ///< Calibration test run
+  PUMP_REASON_REMOTE = 3,      ///< Watering requested over Serial
+  PUMP_REASON_DRY = 4,         ///< Auto mode, soil dried below the profile
+};
+
+/**
+ * @brief Fields common to every record
+ */
+struct __attribute__((packed)) TelemetryHeader {
+  uint8_t type;    ///< TelemetryType
+  uint8_t seq;     ///< Wraps at 256; gaps reveal dropped frames
+  uint32_t timeMs; ///< millis() when the record was built
+};
+
+/**
+ * @brief Periodic snapshot, 26 bytes
+ */
+struct __attribute__((packed)) TelemetryStatus {
+  TelemetryHeader header;
+  uint16_t moistureRaw;      ///< Last soil ADC reading (0-1023)
+  uint8_t moisturePercent;   ///< Same reading mapped to 0-100
+  uint16_t moistureAgeS;     ///< Age of that reading (s, saturates)
+  uint16_t waterDetectRaw;   ///< Last spill-probe ADC reading
+  uint8_t flags;             ///< TELEMETRY_FLAG_* bits
+  uint16_t intervalMinutes;  ///< Auto-mode watering interval
+  uint32_t secondsToWatering; ///< Countdown to next watering (0 if off)
+  uint16_t tankMl;           ///< Estimated tank volume
+  uint16_t hoursToLow;       ///< Predicted hours until low (0xFFFF: none)
+  uint16_t droppedFrames;    ///< telemetryDropped() since boot (wraps)
+};
+
+/**
+ * @brief Pump transition, 14 bytes
+ */
+struct __attribute__((packed)) TelemetryPump {
+  TelemetryHeader header;
+  uint8_t on;         ///< 1 = started, 0 = stopped
+  uint8_t reason;     ///< TelemetryPumpReason
+  uint32_t runtimeMs; ///< On-time of the run that just ended (0 when on)
+  uint16_t volumeMl;  ///< Volume of that run: measured, or from calibration
+};
+
+/**
+ * @brief LCD row mirror, 23 bytes
+ */
+struct __attribute__((packed)) TelemetryLcdRow {
+  TelemetryHeader header;
+  uint8_t row;   ///< Row index, 0 = top
+  char text[16]; ///< Row contents, space padded
+};
+
+/**
+ * @brief Supervisor fault, 8 bytes
+ */
+struct __attribute__((packed)) TelemetryFault {
+  TelemetryHeader header;
+  uint8_t fault; ///< SupervisorFault
+  uint8_t count; ///< Faults since power-on
+};
+
+/**
+ * @brief Batch of recorded input events, up to 32 bytes
+ * @details Only the used part of events is sent, so the record is variable
+ * length. Event encoding in Recorder.h.
+ */
+struct __attribute__((packed)) TelemetryTrace {
+  TelemetryHeader header;
+  uint32_t startMs;   ///< millis() of the first event
+  uint16_t lost;      ///< recordLost() when sent; a rise marks a gap
+  uint8_t events[20]; ///< Packed events
+};
+
+/**
+ * @brief Fills a record header and assigns the next sequence number
+ * @param header Header to fill
+ * @param type Record type
+ */
+void telemetryHeader(TelemetryHeader &header, TelemetryType type);
+
+/**
+ * @brief Frames a record and queues it for transmission
+ * @param record Record bytes, starting with a TelemetryHeader
+ * @param size Record size in bytes (at most 32)
+ * @return false if the frame did not fit and was dropped
+ */
+bool telemetrySend(const void *record, uint8_t size);
+
+/**
+ * @brief Moves queued bytes into the Serial TX buffer without blocking
+ */
+void telemetryService();
+
+/**
+ * @brief Reports whether frames are still waiting to be sent
+ */
+bool telemetryPending();
+
+/**
+ * @brief Number of frames dropped because the ring was full
+ */
+uint16_t telemetryDropped();
+
+/**
+ * @brief CRC-16/CCITT-FALSE update for one byte
+ * @param crc Running CRC (start with 0xFFFF)
+ * @param data Next byte
+ * @return Updated CRC
+ */
+uint16_t telemetryCrc16(uint16_t crc, uint8_t data);
+
+#endif
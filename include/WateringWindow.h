@@ -0,0 +1,96 @@
+/**
+ * @file WateringWindow.h
+ * @brief Watering windows, quiet hours and batching of due waterings
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Auto mode used to water the moment a watering came due, at a time
+ * set by millis() since the last one, so controllers sharing a rack pumped at
+ * scattered times, night included. A due watering now goes through here:
+ * - inside an allowed window it runs at once
+ * - outside, it waits for the next window to open (RTC hours); whatever else
+ *   comes due meanwhile joins it, so the wait ends in one run
+ * - one coming due within the batch time (windowBatchMinutes()) after a run
+ *   is folded into that run
+ * - no watering waits longer than Hw::wateringMaxLateMin, window or not, so
+ *   quiet hours cannot starve a plant
+ *
+ * Windows are whole hours, set with `s wn` (default: all day). The wait is
+ * worked out from the RTC when the watering comes due and then timed with
+ * millis(), so the check on every pass does not touch the RTC.
+ */
+
+#ifndef WATERING_WINDOW_H
+#define WATERING_WINDOW_H
+
+#include <Arduino.h>
+#include <RtcDS1302.h>
+
+/**
+ * @brief Sets the allowed hours
+ * @param hours Bit h set: watering may start during hour h (plantHours())
+ */
+void windowSetHours(uint32_t hours);
+
+/**
+ * @brief Allowed hours, bit h for hour h
+ */
+uint32_t windowHours();
+
+/**
+ * @brief Sets how close to a run another due watering is folded into it
+ * @param minutes Batch time, 0 to never fold
+ */
+void windowSetBatchMinutes(uint8_t minutes);
+
+/**
+ * @brief Batch time (minutes)
+ */
+uint8_t windowBatchMinutes();
+
+/**
+ * @brief Takes a watering that has come due
+ * @param reason TelemetryPumpReason it would run with
+ * @param now RTC time
+ * @return false when it was folded into the last run (nothing to do)
+ * @details Joins a watering already waiting, keeping its reason and time.
+ */
+bool windowQueue(uint8_t reason, const RtcDateTime &now);
+
+/**
+ * @brief Makes a watering wait a set time, regardless of window and batch
+ * @param reason TelemetryPumpReason it will run with
+ * @param waitMs How long from now
+ * @details For the rest of a dose split to let the pump cool (PumpDrive.h).
+ */
+void windowRetry(uint8_t reason, unsigned long waitMs);
+
+/**
+ * @brief Whether a watering is waiting
+ */
+bool windowPending();
+
+/**
+ * @brief Hands over the waiting watering once it may run
+ * @param reason Set to its TelemetryPumpReason
+ * @return true when it is time (the watering is no longer waiting)
+ */
+bool windowReady(uint8_t &reason);
+
+/**
+ * @brief Milliseconds until the waiting watering may run, 0 if none waits
+ */
+unsigned long windowDueIn();
+
+/**
+ * @brief Records that the pump just watered (for any reason)
+ * @details Satisfies a waiting watering and starts the batch time.
+ */
+void windowRan();
+
+/**
+ * @brief Drops a waiting watering (auto mode restarted)
+ */
+void windowCancel();
+
+#endif
@@ -0,0 +1,266 @@
+/**
+ * @file Arduino.h
+ * @brief Host-side stand-in for the Arduino core used by the native build
+ * @details Provides just enough of the Arduino API for the firmware sources to
+ * compile and run on a workstation:
+ * - Virtual microsecond clock advanced by delay() and by every I/O call
+ * - Digital, analog and PWM pin state held in plain arrays
+ * - String, Print and a Serial port backed by in-memory buffers
+ *
+ * The native:: namespace exposes the simulated board to host-only code.
+ */
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+// ========================================
+// CORE TYPES AND CONSTANTS
+// ========================================
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+static const uint8_t A0 = 14;
+static const uint8_t A1 = 15;
+static const uint8_t A2 = 16;
+static const uint8_t A3 = 17;
+static const uint8_t A4 = 18;
+static const uint8_t A5 = 19;
+static const uint8_t NUM_DIGITAL_PINS = 20;
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define snprintf_P snprintf
+
+// Same macro semantics as the AVR core, so constants passed to them are not
+// ODR-used and static constexpr members need no out-of-class definition.
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(amt, low, high)                                              \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define interrupts()
+#define noInterrupts()
+
+class __FlashStringHelper;
+
+// ========================================
+// CORE FUNCTIONS
+// ========================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+// ========================================
+// STRING
+// ========================================
+
+class String {
+public:
+  String() {}
+  String(const char *s) : s_(s ? s : "") {}
+  String(const __FlashStringHelper *s)
+      : s_(reinterpret_cast<const char *>(s)) {}
+  String(char c) : s_(1, c) {}
+  String(int v, unsigned char base = DEC);
+  String(unsigned int v, unsigned char base = DEC);
+  String(long v, unsigned char base = DEC);
+  String(unsigned long v, unsigned char base = DEC);
+  String(float v, unsigned char decimals = 2);
+  String(double v, unsigned char decimals = 2);
+
+  unsigned int length() const { return s_.size(); }
+  char charAt(unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  const char *c_str() const { return s_.c_str(); }
+  bool concat(const String &o) {
+    s_ += o.s_;
+    return true;
+  }
+  String &operator+=(const String &o) {
+    s_ += o.s_;
+    return *this;
+  }
+  bool operator==(const String &o) const { return s_ == o.s_; }
+  bool operator!=(const String &o) const { return s_ != o.s_; }
+
+  friend String operator+(const String &a, const String &b) {
+    String r(a);
+    r += b;
+    return r;
+  }
+
+private:
+  std::string s_;
+};
+
+// ========================================
+// PRINT
+// ========================================
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str) {
+    return write(reinterpret_cast<const uint8_t *>(str), strlen(str));
+  }
+
+  size_t print(const __FlashStringHelper *s) {
+    return write(reinterpret_cast<const char *>(s));
+  }
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+  size_t print(unsigned char v, int base = DEC) {
+    return print(static_cast<unsigned long>(v), base);
+  }
+  size_t print(int v, int base = DEC) { return print(static_cast<long>(v), base); }
+  size_t print(unsigned int v, int base = DEC) {
+    return print(static_cast<unsigned long>(v), base);
+  }
+  size_t print(long v, int base = DEC);
+  size_t print(unsigned long v, int base = DEC);
+  size_t print(double v, int digits = 2);
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(const T &v) {
+    size_t n = print(v);
+    return n + println();
+  }
+  template <typename T> size_t println(const T &v, int fmt) {
+    size_t n = print(v, fmt);
+    return n + println();
+  }
+};
+
+// ========================================
+// SERIAL
+// ========================================
+
+/**
+ * @brief In-memory serial port
+ * @details Host code feeds RX bytes with native::serialInject() and collects
+ * TX bytes from native::serialOutput(). When native::serialEcho is set, TX
+ * bytes are also copied to stdout.
+ */
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { baud_ = baud; }
+  void end() {}
+  int available();
+  int availableForWrite();
+  int peek();
+  int read();
+  void flush() {}
+  size_t write(uint8_t c) override;
+  using Print::write;
+  explicit operator bool() const { return true; }
+
+private:
+  unsigned long baud_ = 0;
+};
+
+extern HardwareSerial Serial;
+
+// ========================================
+// SIMULATED BOARD
+// ========================================
+
+namespace native {
+
+/// Current virtual time in microseconds
+extern uint64_t nowMicros;
+/// Logic level seen on each digital input (driven by host code)
+extern uint8_t pinLevel[NUM_DIGITAL_PINS];
+/// Mode last set with pinMode()
+extern uint8_t pinModes[NUM_DIGITAL_PINS];
+/// Value returned by analogRead() for each pin
+extern uint16_t analogValue[NUM_DIGITAL_PINS];
+/// Last analogWrite() duty per pin
+extern uint8_t pwmValue[NUM_DIGITAL_PINS];
+/// Copy Serial TX to stdout
+extern bool serialEcho;
+/**
+ * @brief Called with the pin before every digitalRead(), analogRead() and
+ * analogWrite()
+ * @details Lets a host model bring its inputs up to the current virtual time
+ * lazily, integrating over the outputs as they were since its last call.
+ */
+extern void (*ioHook)(uint8_t pin);
+/**
+ * @brief Called by delay() with the time asked for, in microseconds
+ * @details Returns the time that passes instead, which may be longer: lets a
+ * host model jump the virtual clock while the firmware only waits.
+ */
+extern uint64_t (*delayHook)(uint64_t us);
+
+/// Advances the virtual clock without running any firmware code
+void advanceMicros(uint64_t us);
+/// Queues bytes for Serial.read()
+void serialInject(const uint8_t *data, size_t size);
+/// Returns and clears everything written to Serial so far
+std::string serialOutput();
+
+/**
+ * @brief Attaches a synthetic pulse train (e.g. a flow meter) to a pin
+ * @param pin Pin whose pulses are counted
+ * @param drivePin PWM pin the rate follows (pulse rate scales with its duty)
+ * @param hzAtFullDuty Pulse rate at analogWrite(drivePin, 255); 0 = stalled
+ */
+void pulseSource(uint8_t pin, uint8_t drivePin, double hzAtFullDuty);
+/// Reports whether pulseSource() was set up for a pin
+bool hasPulseSource(uint8_t pin);
+/// Pulses generated on a pin so far (what an edge-counting ISR would count)
+uint32_t pulseCount(uint8_t pin);
+
+} // namespace native
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * @file EEPROM.h
+ * @brief Host-side stand-in for the Arduino EEPROM library
+ * @details 1 KB like the ATmega328P, erased (0xFF) at start. Each byte
+ * actually written costs 3.3 ms of virtual time and is counted, so wear can
+ * be measured.
+ */
+
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <Arduino.h>
+
+namespace native {
+/// EEPROM contents
+extern uint8_t eeprom[1024];
+/// Bytes written (erase/write cycles) since start
+extern uint32_t eepromWrites;
+} // namespace native
+
+class EEPROMClass {
+public:
+  uint8_t read(int address) {
+    return address >= 0 && address < length() ? native::eeprom[address] : 0xFF;
+  }
+  void write(int address, uint8_t value);
+  void update(int address, uint8_t value) {
+    if (read(address) != value) {
+      write(address, value);
+    }
+  }
+  uint16_t length() { return sizeof(native::eeprom); }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
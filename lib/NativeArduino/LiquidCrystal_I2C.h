@@ -0,0 +1,52 @@
+/**
+ * @file LiquidCrystal_I2C.h
+ * @brief Host-side stand-in for the LiquidCrystal_I2C library
+ * @details Renders into an in-memory character frame that host code can
+ * inspect, instead of talking to a PCF8574 backpack.
+ */
+
+#ifndef NATIVE_LIQUIDCRYSTAL_I2C_H
+#define NATIVE_LIQUIDCRYSTAL_I2C_H
+
+#include <Arduino.h>
+
+class LiquidCrystal_I2C : public Print {
+public:
+  LiquidCrystal_I2C(uint8_t address, uint8_t cols, uint8_t rows);
+
+  void init();
+  void begin(uint8_t cols, uint8_t rows) {
+    cols_ = cols;
+    rows_ = rows;
+  }
+  void clear();
+  void home() { setCursor(0, 0); }
+  void setCursor(uint8_t col, uint8_t row);
+  void backlight() { backlight_ = true; }
+  void noBacklight() { backlight_ = false; }
+  void blink() {}
+  void noBlink() {}
+  void cursor() {}
+  void noCursor() {}
+  void display() {}
+  void noDisplay() {}
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  /// Returns one row of the simulated display, padded with spaces
+  String row(uint8_t row) const;
+  bool isBacklightOn() const { return backlight_; }
+
+private:
+  static const uint8_t maxCols = 20;
+  static const uint8_t maxRows = 4;
+  uint8_t address_;
+  uint8_t cols_;
+  uint8_t rows_;
+  uint8_t col_ = 0;
+  uint8_t row_ = 0;
+  bool backlight_ = false;
+  char frame_[maxRows][maxCols];
+};
+
+#endif
@@ -0,0 +1,406 @@
+/**
+ * @file NativeArduino.cpp
+ * @brief Simulated board behind the host-side Arduino API
+ * @details Every API call charges a rough AVR cost to the virtual clock so
+ * busy-wait loops in the firmware still make progress in simulated time.
+ */
+
+#include <deque> // before Arduino.h, whose min/max macros break <deque>
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <LiquidCrystal_I2C.h>
+#include <RtcDS1302.h>
+#include <Wire.h>
+
+namespace native {
+
+uint64_t nowMicros = 0;
+uint8_t pinLevel[NUM_DIGITAL_PINS];
+uint8_t pinModes[NUM_DIGITAL_PINS];
+uint16_t analogValue[NUM_DIGITAL_PINS];
+uint8_t pwmValue[NUM_DIGITAL_PINS];
+bool serialEcho = false;
+void (*ioHook)(uint8_t pin) = nullptr;
+uint64_t (*delayHook)(uint64_t us) = nullptr;
+bool i2cPresent[128];
+uint32_t rtcEpoch = 0;
+uint8_t rtcRam[31];
+uint8_t eeprom[1024];
+uint32_t eepromWrites = 0;
+
+static std::deque<uint8_t> serialRx;
+static std::string serialTx;
+
+/**
+ * @brief Pulse train whose rate follows a PWM duty, integrated lazily
+ */
+struct PulseTrain {
+  bool attached;
+  uint8_t drivePin;
+  double hzAtFullDuty;
+  double pulses;       ///< Pulses so far, including the partial one
+  uint64_t lastMicros; ///< Virtual time pulses was brought up to
+};
+static PulseTrain pulseTrains[NUM_DIGITAL_PINS];
+
+/// Brings every train driven by drivePin up to the current virtual time
+static void integratePulses(uint8_t drivePin) {
+  for (PulseTrain &train : pulseTrains) {
+    if (train.attached && train.drivePin == drivePin) {
+      double seconds = (nowMicros - train.lastMicros) / 1e6;
+      train.pulses +=
+          seconds * train.hzAtFullDuty * pwmValue[drivePin] / 255.0;
+      train.lastMicros = nowMicros;
+    }
+  }
+}
+
+/**
+ * @brief Idle-high inputs, an LCD backpack at 0x27 and an erased EEPROM
+ * @details Mirrors a freshly powered board with pull-ups on every input and
+ * nothing pressed.
+ */
+static struct BoardReset {
+  BoardReset() {
+    memset(pinLevel, HIGH, sizeof(pinLevel));
+    i2cPresent[0x27] = true;
+    memset(eeprom, 0xFF, sizeof(eeprom));
+  }
+} boardReset;
+
+void advanceMicros(uint64_t us) { nowMicros += us; }
+
+void serialInject(const uint8_t *data, size_t size) {
+  serialRx.insert(serialRx.end(), data, data + size);
+}
+
+std::string serialOutput() {
+  std::string out;
+  out.swap(serialTx);
+  return out;
+}
+
+void pulseSource(uint8_t pin, uint8_t drivePin, double hzAtFullDuty) {
+  if (pin >= NUM_DIGITAL_PINS || drivePin >= NUM_DIGITAL_PINS)
+    return;
+  PulseTrain &train = pulseTrains[pin];
+  if (train.attached)
+    integratePulses(train.drivePin);
+  else
+    train.lastMicros = nowMicros;
+  train.attached = true;
+  train.drivePin = drivePin;
+  train.hzAtFullDuty = hzAtFullDuty;
+}
+
+bool hasPulseSource(uint8_t pin) {
+  return pin < NUM_DIGITAL_PINS && pulseTrains[pin].attached;
+}
+
+uint32_t pulseCount(uint8_t pin) {
+  if (!hasPulseSource(pin))
+    return 0;
+  integratePulses(pulseTrains[pin].drivePin);
+  return static_cast<uint32_t>(pulseTrains[pin].pulses);
+}
+
+} // namespace native
+
+// ========================================
+// CORE FUNCTIONS
+// ========================================
+
+unsigned long millis() {
+  native::nowMicros += 4;
+  return static_cast<unsigned long>(native::nowMicros / 1000ULL);
+}
+
+unsigned long micros() {
+  native::nowMicros += 4;
+  return static_cast<unsigned long>(native::nowMicros);
+}
+
+void delay(unsigned long ms) {
+  uint64_t us = ms * 1000ULL;
+  native::nowMicros += native::delayHook ? native::delayHook(us) : us;
+}
+
+void delayMicroseconds(unsigned int us) { native::nowMicros += us; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < NUM_DIGITAL_PINS)
+    native::pinModes[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  native::nowMicros += 4;
+  if (pin < NUM_DIGITAL_PINS)
+    native::pinLevel[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  native::nowMicros += 4;
+  if (native::ioHook)
+    native::ioHook(pin);
+  return pin < NUM_DIGITAL_PINS ? native::pinLevel[pin] : LOW;
+}
+
+int analogRead(uint8_t pin) {
+  native::nowMicros += 112; // one ADC conversion at the default prescaler
+  if (native::ioHook)
+    native::ioHook(pin);
+  return pin < NUM_DIGITAL_PINS ? native::analogValue[pin] : 0;
+}
+
+void analogWrite(uint8_t pin, int val) {
+  native::nowMicros += 4;
+  if (native::ioHook)
+    native::ioHook(pin);
+  if (pin < NUM_DIGITAL_PINS) {
+    native::integratePulses(pin); // at the old duty up to now
+    native::pwmValue[pin] = static_cast<uint8_t>(constrain(val, 0, 255));
+  }
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+static uint32_t randomState = 1;
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0)
+    randomState = seed;
+}
+
+long random(long howBig) {
+  if (howBig == 0)
+    return 0;
+  // xorshift32: deterministic across hosts, unlike rand()
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState % howBig;
+}
+
+long random(long howSmall, long howBig) {
+  if (howSmall >= howBig)
+    return howSmall;
+  return random(howBig - howSmall) + howSmall;
+}
+
+// ========================================
+// STRING AND PRINT
+// ========================================
+
+static std::string formatNumber(unsigned long v, unsigned char base) {
+  if (base < 2)
+    base = 10;
+  std::string out;
+  do {
+    unsigned char digit = v % base;
+    out.insert(out.begin(), digit < 10 ? '0' + digit : 'A' + digit - 10);
+    v /= base;
+  } while (v != 0);
+  return out;
+}
+
+static std::string formatFloat(double v, unsigned char decimals) {
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", decimals, v);
+  return buffer;
+}
+
+String::String(int v, unsigned char base) : String(static_cast<long>(v), base) {}
+
+String::String(unsigned int v, unsigned char base)
+    : String(static_cast<unsigned long>(v), base) {}
+
+String::String(long v, unsigned char base) {
+  if (v < 0 && base == DEC) {
+    s_ = "-" + formatNumber(static_cast<unsigned long>(-v), base);
+  } else {
+    s_ = formatNumber(static_cast<unsigned long>(v), base);
+  }
+}
+
+String::String(unsigned long v, unsigned char base)
+    : s_(formatNumber(v, base)) {}
+
+String::String(float v, unsigned char decimals)
+    : s_(formatFloat(v, decimals)) {}
+
+String::String(double v, unsigned char decimals)
+    : s_(formatFloat(v, decimals)) {}
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::print(long v, int base) {
+  return print(String(v, static_cast<unsigned char>(base)));
+}
+
+size_t Print::print(unsigned long v, int base) {
+  return print(String(v, static_cast<unsigned char>(base)));
+}
+
+size_t Print::print(double v, int digits) {
+  return print(String(v, static_cast<unsigned char>(digits)));
+}
+
+// ========================================
+// SERIAL
+// ========================================
+
+HardwareSerial Serial;
+
+int HardwareSerial::available() {
+  return static_cast<int>(native::serialRx.size());
+}
+
+int HardwareSerial::availableForWrite() { return 63; }
+
+int HardwareSerial::peek() {
+  return native::serialRx.empty() ? -1 : native::serialRx.front();
+}
+
+int HardwareSerial::read() {
+  if (native::serialRx.empty())
+    return -1;
+  uint8_t c = native::serialRx.front();
+  native::serialRx.pop_front();
+  return c;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  native::serialTx.push_back(static_cast<char>(c));
+  if (native::serialEcho)
+    putchar(c);
+  return 1;
+}
+
+// ========================================
+// EEPROM
+// ========================================
+
+EEPROMClass EEPROM;
+
+void EEPROMClass::write(int address, uint8_t value) {
+  if (address < 0 || address >= length())
+    return;
+  native::eeprom[address] = value;
+  ++native::eepromWrites;
+  native::nowMicros += 3300; // erase + write cycle
+}
+
+// ========================================
+// WIRE
+// ========================================
+
+TwoWire Wire;
+
+uint8_t TwoWire::endTransmission(bool) {
+  native::nowMicros += 100; // address byte at 100 kHz
+  return native::i2cPresent[address_ & 0x7F] ? 0 : 2; // 2 = NACK on address
+}
+
+// ========================================
+// LIQUIDCRYSTAL_I2C
+// ========================================
+
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t address, uint8_t cols,
+                                     uint8_t rows)
+    : address_(address), cols_(cols), rows_(rows) {
+  memset(frame_, ' ', sizeof(frame_));
+}
+
+void LiquidCrystal_I2C::init() {
+  clear();
+  backlight_ = false;
+}
+
+void LiquidCrystal_I2C::clear() {
+  native::nowMicros += 2000; // HD44780 clear-display execution time
+  memset(frame_, ' ', sizeof(frame_));
+  col_ = 0;
+  row_ = 0;
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row) {
+  native::nowMicros += 200;
+  col_ = col;
+  row_ = row < rows_ ? row : rows_ - 1;
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t c) {
+  native::nowMicros += 200; // one character over I2C at 100 kHz
+  if (col_ < cols_ && col_ < maxCols && row_ < maxRows) {
+    frame_[row_][col_] = static_cast<char>(c);
+  }
+  ++col_;
+  return 1;
+}
+
+String LiquidCrystal_I2C::row(uint8_t row) const {
+  char buffer[maxCols + 1];
+  uint8_t cols = cols_ < maxCols ? cols_ : maxCols;
+  memcpy(buffer, frame_[row < maxRows ? row : 0], cols);
+  buffer[cols] = '\0';
+  return String(buffer);
+}
+
+// ========================================
+// RTCDATETIME
+// ========================================
+
+static const uint32_t secondsPerDay = 86400UL;
+
+// Days since 2000-01-01 for a proleptic Gregorian date (Hinnant's algorithm)
+static int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+  y -= m <= 2;
+  const int32_t era = (y >= 0 ? y : y - 399) / 400;
+  const uint32_t yoe = static_cast<uint32_t>(y - era * 400);
+  const uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<int32_t>(doe) - 730425; // 730425 = 2000-01-01
+}
+
+RtcDateTime::RtcDateTime(uint32_t secondsFrom2000) {
+  int32_t z = static_cast<int32_t>(secondsFrom2000 / secondsPerDay) + 730425;
+  uint32_t rem = secondsFrom2000 % secondsPerDay;
+  const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const uint32_t doe = static_cast<uint32_t>(z - era * 146097);
+  const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const uint32_t mp = (5 * doy + 2) / 153;
+  const uint32_t d = doy - (153 * mp + 2) / 5 + 1;
+  const uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+  year_ = static_cast<uint16_t>(static_cast<int32_t>(yoe) + era * 400 + (m <= 2));
+  month_ = static_cast<uint8_t>(m);
+  day_ = static_cast<uint8_t>(d);
+  hour_ = static_cast<uint8_t>(rem / 3600);
+  minute_ = static_cast<uint8_t>((rem % 3600) / 60);
+  second_ = static_cast<uint8_t>(rem % 60);
+}
+
+RtcDateTime::RtcDateTime(uint16_t year, uint8_t month, uint8_t dayOfMonth,
+                         uint8_t hour, uint8_t minute, uint8_t second)
+    : year_(year), month_(month), day_(dayOfMonth), hour_(hour),
+      minute_(minute), second_(second) {}
+
+uint32_t RtcDateTime::TotalSeconds() const {
+  int32_t days = daysFromCivil(year_, month_, day_);
+  return static_cast<uint32_t>(days) * secondsPerDay + hour_ * 3600UL +
+         minute_ * 60UL + second_;
+}
+
+uint8_t RtcDateTime::DayOfWeek() const {
+  // 2000-01-01 was a Saturday; 0 = Sunday as in the Rtc library
+  return static_cast<uint8_t>((daysFromCivil(year_, month_, day_) + 6) % 7);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file RtcDS1302.h
+ * @brief Host-side stand-in for the Makuna Rtc library (DS1302 flavour)
+ * @details The simulated RTC keeps time as an offset from the virtual clock,
+ * so it advances exactly with millis(). The 31 bytes of battery-backed RAM are
+ * modelled as a plain array.
+ */
+
+#ifndef NATIVE_RTCDS1302_H
+#define NATIVE_RTCDS1302_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Calendar date/time, counted in seconds from 2000-01-01 00:00:00
+ */
+class RtcDateTime {
+public:
+  RtcDateTime(uint32_t secondsFrom2000 = 0);
+  RtcDateTime(uint16_t year, uint8_t month, uint8_t dayOfMonth, uint8_t hour,
+              uint8_t minute, uint8_t second);
+
+  bool IsValid() const { return true; }
+  uint16_t Year() const { return year_; }
+  uint8_t Month() const { return month_; }
+  uint8_t Day() const { return day_; }
+  uint8_t Hour() const { return hour_; }
+  uint8_t Minute() const { return minute_; }
+  uint8_t Second() const { return second_; }
+  uint8_t DayOfWeek() const;
+  uint32_t TotalSeconds() const;
+
+private:
+  uint16_t year_;
+  uint8_t month_;
+  uint8_t day_;
+  uint8_t hour_;
+  uint8_t minute_;
+  uint8_t second_;
+};
+
+class ThreeWire {
+public:
+  ThreeWire(uint8_t ioPin, uint8_t clkPin, uint8_t cePin) {
+    (void)ioPin;
+    (void)clkPin;
+    (void)cePin;
+  }
+};
+
+namespace native {
+/// RTC time at virtual time zero, in seconds from 2000
+extern uint32_t rtcEpoch;
+/// DS1302 battery-backed RAM
+extern uint8_t rtcRam[31];
+} // namespace native
+
+template <class T_WIRE_METHOD> class RtcDS1302 {
+public:
+  static const uint8_t MemorySize = 31;
+
+  explicit RtcDS1302(T_WIRE_METHOD &wire) { (void)wire; }
+
+  void Begin() {}
+  bool GetIsWriteProtected() { return false; }
+  void SetIsWriteProtected(bool) {}
+  bool GetIsRunning() { return true; }
+  void SetIsRunning(bool) {}
+
+  void SetDateTime(const RtcDateTime &dt) {
+    native::rtcEpoch = dt.TotalSeconds() - millis() / 1000UL;
+  }
+  RtcDateTime GetDateTime() {
+    return RtcDateTime(native::rtcEpoch + millis() / 1000UL);
+  }
+
+  void SetMemory(uint8_t memoryAddress, uint8_t value) {
+    if (memoryAddress < MemorySize)
+      native::rtcRam[memoryAddress] = value;
+  }
+  uint8_t GetMemory(uint8_t memoryAddress) {
+    return memoryAddress < MemorySize ? native::rtcRam[memoryAddress] : 0;
+  }
+  uint8_t SetMemory(const uint8_t *pValue, uint8_t countBytes) {
+    if (countBytes > MemorySize)
+      countBytes = MemorySize;
+    memcpy(native::rtcRam, pValue, countBytes);
+    return countBytes;
+  }
+  uint8_t GetMemory(uint8_t *pValue, uint8_t countBytes) {
+    if (countBytes > MemorySize)
+      countBytes = MemorySize;
+    memcpy(pValue, native::rtcRam, countBytes);
+    return countBytes;
+  }
+};
+
+#endif
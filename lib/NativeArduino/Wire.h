@@ -0,0 +1,32 @@
+/**
+ * @file Wire.h
+ * @brief Host-side stand-in for the Arduino TwoWire (I2C) library
+ * @details Devices are modelled only as present/absent addresses, which is all
+ * the firmware needs to probe for its peripherals.
+ */
+
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+  void begin() {}
+  void setClock(uint32_t) {}
+  void beginTransmission(uint8_t address) { address_ = address; }
+  uint8_t endTransmission(bool = true);
+  size_t write(uint8_t) { return 1; }
+
+private:
+  uint8_t address_ = 0;
+};
+
+extern TwoWire Wire;
+
+namespace native {
+/// I2C addresses that acknowledge; 0x27 (the LCD backpack) by default
+extern bool i2cPresent[128];
+} // namespace native
+
+#endif
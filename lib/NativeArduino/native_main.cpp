@@ -0,0 +1,28 @@
+/**
+ * @file native_main.cpp
+ * @brief Default entry point for the native build
+ * @details Runs the sketch's setup() and loop() against the virtual clock for
+ * NATIVE_RUN_SECONDS of simulated time (60 by default) with Serial echoed to
+ * stdout. Host programs that define their own main() replace this one, since
+ * the linker only pulls it out of the library archive when main is missing.
+ */
+
+#include <Arduino.h>
+
+void setup();
+void loop();
+
+int main() {
+  const char *env = getenv("NATIVE_RUN_SECONDS");
+  const uint64_t runMicros =
+      (env ? strtoull(env, nullptr, 10) : 60ULL) * 1000000ULL;
+
+  native::serialEcho = true;
+  setup();
+  while (native::nowMicros < runMicros) {
+    loop();
+  }
+  printf("\nsimulated %llu s\n",
+         static_cast<unsigned long long>(native::nowMicros / 1000000ULL));
+  return 0;
+}
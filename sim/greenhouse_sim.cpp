@@ -0,0 +1,578 @@
+/**
+ * @file greenhouse_sim.cpp
+ * @brief A month in the greenhouse, simulated on the host
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Runs the unmodified firmware (setup()/loop() from src/) on the
+ * NativeArduino virtual clock against:
+ * - a pot: soil water with diurnal evapotranspiration that varies by day,
+ *   drainage above field capacity into a saucer, and the soil and spill probe
+ *   readings that follow from it (only while their supply pins are high)
+ * - a tank emptied by the pump and tripping the float switch at its low mark
+ * - a scripted trace of button presses, refills and Serial lines
+ *
+ * Nothing is stepped on a timer: every model is brought up to date from
+ * native::ioHook, i.e. whenever the firmware touches a pin, so auto mode runs
+ * through the real autoWateringCheck(), waterPlant(), isPlantOkayToWater()
+ * and readSoilMoisture() at whatever cadence the firmware really has.
+ *
+ * Since the clock screen never returns to loop(), latency is measured as the
+ * gap between button polls, weighted by time: pN is the gap a press at a
+ * random moment lands in. Gaps of blockedGapMs or more count as blocked.
+ *
+ * While the firmware only polls (pump and valve off, nothing queued on
+ * Serial, no animation), native::delayHook stretches its delay() up to
+ * maxJumpMs, stopping short of the next trace action, sample or watering.
+ * The polls skipped that way are booked at the loop's own period, so the
+ * gap statistics are those of an unbroken run.
+ *
+ * Usage: program [trace-file]. Trace lines are "<time> <action> [args]",
+ * time as e.g. 90s, 12h or 2d9h30m from the start of the run:
+ * - press <-|+|M|A> [hold ms]
+ * - refill [ml] (to capacity by default)
+ * - pour <ml> (watered by hand)
+ * - serial <command line>
+ * - end
+ * Without a file the built-in trace below runs.
+ */
+
+#include <time.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include <RtcDS1302.h>
+
+#include "Animation.h"
+#include "EventLog.h"
+#include "HardwareProfile.h"
+#include "SoilSampler.h"
+#include "Telemetry.h"
+
+void setup();
+void loop();
+
+extern bool isAutoModeEnabled;
+extern unsigned long autoTimer;
+extern unsigned int waterInterval;
+extern uint8_t pumpReason;
+extern EventKind lastWaterBlock;
+unsigned long millisUntilWatering();
+
+namespace {
+
+/**
+ * @name Models
+ * @{
+ */
+const double potCapacityMl = 500.0;     ///< Soil water at field capacity
+const double etNightMlPerHour = 3.0;    ///< Evapotranspiration, night
+const double etNoonMlPerHour = 25.0;    ///< Evapotranspiration, noon peak
+const double drainSeconds = 600.0;      ///< Excess water drains with this tau
+const double saucerMlPerHour = 4.0;     ///< Saucer evaporation
+const double pumpMlPerSecond = 20.0;    ///< 1.2 l/min, as the flow meter stub
+const double dryStressPercent = 20.0;   ///< Below: plant under stress
+const uint16_t probeDryRaw = 120;       ///< Spill probe reading, dry saucer
+const uint16_t probeRawPerMl = 25;      ///< Spill probe rise per ml in saucer
+/** @} */
+
+const uint16_t blockedGapMs = 100; ///< Poll gap a user notices
+const uint16_t histogramMs = 10000; ///< Gap histogram range, 1 ms buckets
+const uint16_t maxJumpMs = 500; ///< Longest idle delay(), one colon blink
+const uint64_t startSeconds = 8 * 3600UL; ///< 08:00 on the first day
+
+const char defaultTrace[] =
+    "# Auto mode, one cup every 6 h, tank topped up about weekly\n"
+    "10s press A\n" // Auto mode: "How much water?"
+    "12s press M\n" // 1.0 cups
+    "13s press +\n" // 120 min
+    "14s press +\n"
+    "15s press +\n"
+    "16s press +\n"
+    "17s press +\n" // 360 min
+    "18s press M\n" // enabled, clock screen
+    "6d18h refill\n"
+    "12d2h press M\n" // check the moisture on the clock screen
+    "13d19h refill\n"
+    "20d7h refill\n"
+    "27d20h refill\n"
+    "30d end\n";
+
+enum ActionKind { ACTION_PIN, ACTION_REFILL, ACTION_POUR, ACTION_SERIAL,
+                  ACTION_END };
+
+struct Action {
+  uint64_t at; ///< Virtual time (µs)
+  ActionKind kind;
+  uint8_t pin;
+  uint8_t level;
+  double ml;
+  std::string text;
+};
+
+std::vector<Action> trace;
+size_t nextAction = 0;
+
+// World
+uint64_t lastMicros = 0;
+double soilMl = 0.6 * potCapacityMl;
+double saucerMl = 0.0;
+double tankMl = Hw::tankCapacityMl;
+uint32_t noiseState = 2463534242UL;
+uint64_t lastDrain = 0;
+
+// Outcomes
+unsigned long pumpRuns = 0;
+unsigned long scheduleRuns = 0;
+double pumpedMl = 0.0;
+bool pumpWasOn = false;
+unsigned long checks = 0;
+unsigned long skippedWet = 0;
+unsigned long missedTank = 0;
+unsigned long missedSpill = 0;
+unsigned long runsSinceCheck = 0;
+unsigned long lastAutoTimer = 0;
+double intervalTotalMin = 0.0;
+double intervalMaxMin = 0.0;
+unsigned long refills = 0;
+double dryHours = 0.0;
+double standingHours = 0.0;
+double tankLowHours = 0.0;
+
+// Latency
+uint64_t lastPoll = 0;
+uint64_t gapMicros[histogramMs + 1]; ///< Time spent in gaps of each length
+uint64_t gapMax = 0;
+uint64_t loopGap = 0; ///< Last gap between polls, the idle loop's period
+uint64_t blockedMicros = 0;
+uint64_t pressedAt[NUM_DIGITAL_PINS]; ///< Press not yet seen, 0 = none
+unsigned long presses = 0;
+unsigned long pressesMissed = 0;
+uint64_t pressLatencyMax = 0;
+
+/**
+ * @brief Parses "2d9h30m" (also s) into microseconds
+ */
+bool parseTime(const char *text, uint64_t &micros) {
+  uint64_t seconds = 0;
+  while (*text) {
+    char *end;
+    unsigned long n = strtoul(text, &end, 10);
+    if (end == text) {
+      return false;
+    }
+    switch (*end) {
+    case 'd': seconds += n * 86400ULL; break;
+    case 'h': seconds += n * 3600ULL; break;
+    case 'm': seconds += n * 60ULL; break;
+    case 's': seconds += n; break;
+    default: return false;
+    }
+    text = end + 1;
+  }
+  micros = seconds * 1000000ULL;
+  return true;
+}
+
+uint8_t buttonPin(const char *name) {
+  switch (name[0]) {
+  case '-': return Hw::buttonMinus;
+  case '+': return Hw::buttonPlus;
+  case 'M': return Hw::buttonM;
+  case 'A': return Hw::buttonA;
+  }
+  return 0xFF;
+}
+
+/**
+ * @brief Reads a trace, one action per line
+ * @return false (with a message) on the first bad line
+ */
+bool loadTrace(const std::string &text) {
+  size_t lineNo = 0;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t eol = text.find('\n', pos);
+    if (eol == std::string::npos) {
+      eol = text.size();
+    }
+    std::string line = text.substr(pos, eol - pos);
+    pos = eol + 1;
+    ++lineNo;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    char when[32] = {0};
+    char verb[16] = {0};
+    int rest = 0;
+    if (sscanf(line.c_str(), "%31s %15s %n", when, verb, &rest) < 2) {
+      fprintf(stderr, "trace line %zu: expected <time> <action>\n", lineNo);
+      return false;
+    }
+    const char *args = line.c_str() + rest;
+    Action action = Action();
+    if (!parseTime(when, action.at)) {
+      fprintf(stderr, "trace line %zu: bad time '%s'\n", lineNo, when);
+      return false;
+    }
+
+    std::string name(verb);
+    if (name == "press") {
+      action.kind = ACTION_PIN;
+      action.pin = buttonPin(args);
+      unsigned long hold = args[0] ? strtoul(args + 1, nullptr, 10) : 0;
+      if (action.pin == 0xFF) {
+        fprintf(stderr, "trace line %zu: button is - + M or A\n", lineNo);
+        return false;
+      }
+      action.level = LOW;
+      trace.push_back(action);
+      action.level = HIGH;
+      action.at += (hold ? hold : 150) * 1000ULL;
+    } else if (name == "refill") {
+      action.kind = ACTION_REFILL;
+      action.ml = *args ? atof(args) : Hw::tankCapacityMl;
+    } else if (name == "pour") {
+      action.kind = ACTION_POUR;
+      action.ml = atof(args);
+    } else if (name == "serial") {
+      action.kind = ACTION_SERIAL;
+      action.text = std::string(args) + "\n";
+    } else if (name == "end") {
+      action.kind = ACTION_END;
+    } else {
+      fprintf(stderr, "trace line %zu: unknown action '%s'\n", lineNo, verb);
+      return false;
+    }
+    trace.push_back(action);
+  }
+
+  std::stable_sort(trace.begin(), trace.end(),
+                   [](const Action &a, const Action &b) { return a.at < b.at; });
+  if (trace.empty() || trace.back().kind != ACTION_END) {
+    Action end = Action();
+    end.at = 30 * 86400ULL * 1000000ULL;
+    end.kind = ACTION_END;
+    trace.push_back(end);
+  }
+  return true;
+}
+
+double soilPercent() { return 100.0 * soilMl / potCapacityMl; }
+
+/**
+ * @brief Day-to-day weather, 0.7 (overcast) to 1.3 (hot), repeatable
+ */
+double weather(uint64_t day) {
+  uint32_t h = static_cast<uint32_t>(day) * 2654435761UL;
+  h ^= h >> 15;
+  return 0.7 + 0.6 * (h % 1000) / 1000.0;
+}
+
+int noise(int span) {
+  noiseState ^= noiseState << 13;
+  noiseState ^= noiseState >> 17;
+  noiseState ^= noiseState << 5;
+  return static_cast<int>(noiseState % (2 * span + 1)) - span;
+}
+
+/**
+ * @brief One Euler step of pot, saucer and tank over [from, to)
+ */
+void step(uint64_t from, uint64_t to) {
+  double dt = (to - from) / 1e6;
+  double seconds = startSeconds + from / 1e6;
+
+  double flow = native::pwmValue[Hw::pump] / 255.0 * pumpMlPerSecond * dt;
+  flow = fmin(flow, tankMl);
+  tankMl -= flow;
+  soilMl += flow;
+  pumpedMl += flow;
+
+  double hour = fmod(seconds / 3600.0, 24.0);
+  double sun = fmax(0.0, sin(M_PI * (hour - 6.0) / 12.0));
+  double et = (etNightMlPerHour + (etNoonMlPerHour - etNightMlPerHour) * sun) *
+              weather(static_cast<uint64_t>(seconds / 86400.0));
+  // Plants close up as the soil dries
+  et *= fmin(1.0, 2.0 * soilMl / potCapacityMl);
+  soilMl = fmax(0.0, soilMl - et * dt / 3600.0);
+
+  if (soilMl > potCapacityMl) {
+    double drained =
+        (soilMl - potCapacityMl) * fmin(1.0, dt / drainSeconds);
+    soilMl -= drained;
+    saucerMl += drained;
+  }
+  saucerMl = fmax(0.0, saucerMl - saucerMlPerHour * dt / 3600.0);
+
+  if (soilPercent() < dryStressPercent) {
+    dryHours += dt / 3600.0;
+  }
+  if (saucerMl >= 1.0) {
+    standingHours += dt / 3600.0;
+  }
+  if (tankMl <= Hw::tankLowMarkMl) {
+    tankLowHours += dt / 3600.0;
+  }
+}
+
+/**
+ * @brief Advances pot, saucer and tank from lastMicros to now
+ * @details Steps end on whole seconds of virtual time, so the result does not
+ * depend on when the firmware happens to touch a pin.
+ */
+void integrate(uint64_t now) {
+  while (lastMicros < now) {
+    uint64_t next = (lastMicros / 1000000ULL + 1) * 1000000ULL;
+    if (next > now) {
+      next = now;
+    }
+    step(lastMicros, next);
+    lastMicros = next;
+  }
+}
+
+void report();
+
+void apply(const Action &action) {
+  switch (action.kind) {
+  case ACTION_PIN:
+    native::pinLevel[action.pin] = action.level;
+    if (action.level == LOW) {
+      pressedAt[action.pin] = action.at ? action.at : 1;
+      ++presses;
+    } else if (pressedAt[action.pin] != 0) {
+      pressedAt[action.pin] = 0;
+      ++pressesMissed;
+    }
+    break;
+  case ACTION_REFILL:
+    tankMl = fmin(Hw::tankCapacityMl, tankMl + action.ml);
+    ++refills;
+    break;
+  case ACTION_POUR:
+    soilMl += action.ml;
+    break;
+  case ACTION_SERIAL:
+    native::serialInject(reinterpret_cast<const uint8_t *>(action.text.data()),
+                         action.text.size());
+    break;
+  case ACTION_END:
+    report();
+    exit(0);
+  }
+}
+
+void recordGap(uint64_t now) {
+  uint64_t gap = now - lastPoll;
+  lastPoll = now;
+  gapMicros[gap / 1000 < histogramMs ? gap / 1000 : histogramMs] += gap;
+  if (gap > gapMax) {
+    gapMax = gap;
+  }
+  if (gap >= blockedGapMs * 1000ULL) {
+    blockedMicros += gap;
+  }
+  loopGap = gap;
+}
+
+/**
+ * @brief native::delayHook: jumps the clock while the firmware only polls
+ */
+uint64_t onDelay(uint64_t us) {
+  uint64_t now = native::nowMicros;
+  bool idle = native::pwmValue[Hw::pump] == 0 &&
+              native::pinLevel[Hw::pumpValve] == LOW &&
+              Serial.available() == 0 && !telemetryPending() &&
+              !animationActive() && loopGap != 0 &&
+              now - lastPoll < loopGap;
+  if (!idle) {
+    return us;
+  }
+  uint64_t jump = maxJumpMs * 1000ULL;
+  if (nextAction < trace.size() && trace[nextAction].at - now < jump) {
+    jump = trace[nextAction].at - now;
+  }
+  if (soilDueIn() * 1000ULL < jump) {
+    jump = soilDueIn() * 1000ULL;
+  }
+  if (isAutoModeEnabled && millisUntilWatering() * 1000ULL < jump) {
+    jump = millisUntilWatering() * 1000ULL;
+  }
+  if (jump <= us) {
+    return us;
+  }
+  // Book the polls skipped as gaps of the loop's own period
+  uint64_t skipped = jump - us;
+  gapMicros[loopGap / 1000 < histogramMs ? loopGap / 1000 : histogramMs] +=
+      skipped;
+  if (loopGap >= blockedGapMs * 1000ULL) {
+    blockedMicros += skipped;
+  }
+  lastPoll += skipped;
+  return jump;
+}
+
+/**
+ * @brief Bookkeeping for pump runs and auto-mode checks
+ */
+void observeFirmware() {
+  bool pumpOn = native::pwmValue[Hw::pump] != 0;
+  if (pumpOn && !pumpWasOn) {
+    ++pumpRuns;
+    if (pumpReason == PUMP_REASON_SCHEDULE) {
+      ++scheduleRuns;
+      ++runsSinceCheck;
+    }
+  }
+  pumpWasOn = pumpOn;
+
+  if (autoTimer == lastAutoTimer) {
+    return;
+  }
+  // autoWateringCheck() restarts the interval when it is done
+  if (isAutoModeEnabled && lastAutoTimer != 0 && autoTimer != 0) {
+    ++checks;
+    double minutes = (autoTimer - lastAutoTimer) / 60000.0;
+    intervalTotalMin += minutes;
+    intervalMaxMin = fmax(intervalMaxMin, minutes);
+    if (runsSinceCheck == 0) {
+      switch (lastWaterBlock) {
+      case EVENT_SKIP_WET: ++skippedWet; break;
+      case EVENT_SKIP_SPILL: ++missedSpill; break;
+      default: ++missedTank; break;
+      }
+    }
+  }
+  runsSinceCheck = 0;
+  lastAutoTimer = autoTimer;
+}
+
+/**
+ * @brief native::ioHook: runs the world up to now before the firmware looks
+ */
+void onIo(uint8_t pin) {
+  uint64_t now = native::nowMicros;
+  while (nextAction < trace.size() && trace[nextAction].at <= now) {
+    apply(trace[nextAction++]);
+  }
+  // Evaporation is slow: catch up once a second unless water is moving or
+  // the firmware is about to look at the result
+  if (native::pwmValue[Hw::pump] != 0 || pin == Hw::pump ||
+      pin == Hw::soilRead || pin == Hw::waterDetectRead ||
+      now - lastMicros >= 1000000ULL) {
+    integrate(now);
+  }
+  observeFirmware();
+
+  if (Hw::hasFloatSwitch) {
+    native::pinLevel[Hw::floatSwitch] =
+        tankMl > Hw::tankLowMarkMl ? LOW : HIGH;
+  }
+  if (pin == Hw::soilRead) {
+    double raw = Hw::dryValue + (Hw::wetValue - Hw::dryValue) *
+                                    fmin(1.1, soilMl / potCapacityMl);
+    native::analogValue[pin] =
+        native::pinLevel[Hw::soilPower] == HIGH ? raw + noise(4) : 0;
+  } else if (pin == Hw::waterDetectRead) {
+    double raw = probeDryRaw + probeRawPerMl * saucerMl;
+    native::analogValue[pin] =
+        native::pinLevel[Hw::waterDetectPower] == HIGH
+            ? fmin(1023.0, raw) + noise(4)
+            : 0;
+  } else if (pin == Hw::buttonMinus || pin == Hw::buttonPlus ||
+             pin == Hw::buttonM || pin == Hw::buttonA) {
+    if (now - lastPoll >= 1000) { // one scan reads several pins
+      recordGap(now);
+    }
+    if (pressedAt[pin] != 0 && native::pinLevel[pin] == LOW) {
+      if (now - pressedAt[pin] > pressLatencyMax) {
+        pressLatencyMax = now - pressedAt[pin];
+      }
+      pressedAt[pin] = 0;
+    }
+  }
+
+  if (now - lastDrain >= 60000000ULL) {
+    lastDrain = now;
+    native::serialOutput(); // telemetry is not decoded here
+  }
+}
+
+unsigned long gapPercentile(double fraction) {
+  uint64_t total = 0;
+  for (uint64_t micros : gapMicros) {
+    total += micros;
+  }
+  uint64_t sum = 0;
+  for (uint16_t ms = 0; ms <= histogramMs; ++ms) {
+    sum += gapMicros[ms];
+    if (sum >= total * fraction) {
+      return ms;
+    }
+  }
+  return histogramMs;
+}
+
+void report() {
+  double days = native::nowMicros / 86400e6;
+  printf("Simulated      %.1f days from 08:00, %.1f s on this host\n", days,
+         static_cast<double>(clock()) / CLOCKS_PER_SEC);
+  printf("Schedule       every %u min, %lu checks, interval mean %.1f min, "
+         "max %.1f min\n",
+         waterInterval, checks, checks ? intervalTotalMin / checks : 0.0,
+         intervalMaxMin);
+  printf("Waterings      %lu done (%lu scheduled), %.0f ml used\n", pumpRuns,
+         scheduleRuns, pumpedMl);
+  printf("Skipped        %lu soil already wet\n", skippedWet);
+  printf("Missed         %lu tank low, %lu spill probe\n", missedTank,
+         missedSpill);
+  printf("Tank           %lu refills, %.0f ml left, %.1f h at or below the "
+         "low mark\n",
+         refills, tankMl, tankLowHours);
+  printf("Plant          soil %.0f%% now, %.1f h below %.0f%%, %.1f h of "
+         "standing water\n",
+         soilPercent(), dryHours, dryStressPercent, standingHours);
+  printf("Blocked        %.1f s in button poll gaps >= %u ms\n",
+         blockedMicros / 1e6, blockedGapMs);
+  printf("Poll gap       p50 %lu ms, p90 %lu ms, p99 %lu ms, max %.0f ms\n",
+         gapPercentile(0.50), gapPercentile(0.90), gapPercentile(0.99),
+         gapMax / 1e3);
+  printf("Presses        %lu, %lu never seen, slowest seen after %.0f ms\n",
+         presses, pressesMissed, pressLatencyMax / 1e3);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string text = defaultTrace;
+  if (argc > 1) {
+    FILE *file = fopen(argv[1], "r");
+    if (!file) {
+      perror(argv[1]);
+      return 1;
+    }
+    text.clear();
+    char buffer[256];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+      text.append(buffer, n);
+    }
+    fclose(file);
+  }
+  if (!loadTrace(text)) {
+    return 1;
+  }
+
+  native::rtcEpoch = RtcDateTime(2025, 6, 1, 8, 0, 0).TotalSeconds();
+  native::ioHook = onIo;
+  native::delayHook = onDelay;
+  setup();
+  while (true) {
+    loop(); // the trace's end action reports and exits
+  }
+}
@@ -0,0 +1,370 @@
+/**
+ * @file replay.cpp
+ * @brief Replays a recorded input trace through the native HAL
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Feeds the inputs a RECORDING build logged on the board (see
+ * include/Recorder.h; extracted with tools/telemetry_decode.py --trace) back
+ * into the unmodified firmware on the NativeArduino virtual clock:
+ * - pin and ADC events set native::pinLevel / native::analogValue
+ * - RTC events set native::rtcEpoch, so the clock reads as it did
+ * - Serial events are injected as RX bytes
+ *
+ * Events are applied from native::ioHook once millis() reaches their time, so
+ * a read sees what the board saw at the same moment. Each input's first
+ * recorded value is in place from the start, since the native build's timing
+ * only approximates the board's. Flow meter pulses are not in the trace; the
+ * synthetic meter stands in, so metered runs may end differently. Events the
+ * board had to drop ("# lost" lines) are reported when the trace loads.
+ *
+ * What the firmware decides is printed one line per event, prefixed with the
+ * virtual time: pump starts and stops with their reason, supervisor faults,
+ * command replies and, with --lcd, every LCD row change (the Serial mirror is
+ * switched on for the run). Runs are deterministic, so two builds can be
+ * compared with diff and a slow path found with a host profiler. Built with
+ * -DPROFILING (as env:native_replay is) the section histograms are printed at
+ * the end, in virtual time.
+ *
+ * Usage: program trace-file [--lcd] [--status]. The run ends tailMs after the
+ * last event, or at the first "# reset" line.
+ */
+
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include <RtcDS1302.h>
+
+#include "Display.h"
+#include "Profiler.h"
+#include "Telemetry.h"
+
+void setup();
+void loop();
+
+extern Display lcd;
+
+namespace {
+
+const unsigned long tailMs = 5000; ///< Run on after the last event
+
+enum EventKind { EVENT_PIN, EVENT_ADC, EVENT_RTC, EVENT_SERIAL };
+
+struct Event {
+  unsigned long ms;
+  EventKind kind;
+  uint8_t pin;
+  long value;
+};
+
+std::vector<Event> events;
+size_t nextEvent = 0;
+unsigned long endMs = 0;
+unsigned long applied[4] = {0, 0, 0, 0};
+bool showStatus = false;
+
+std::string pendingOutput;
+unsigned long records = 0;
+unsigned long badFrames = 0;
+unsigned long pumpRuns = 0;
+unsigned long pumpMs = 0;
+unsigned long pumpMl = 0;
+
+const char *const reasonNames[] = {"manual", "schedule", "calibration",
+                                   "remote", "dry"};
+
+bool loadTrace(FILE *file) {
+  char line[128];
+  unsigned lineNumber = 0;
+  while (fgets(line, sizeof(line), file)) {
+    ++lineNumber;
+    if (strncmp(line, "# reset", 7) == 0) {
+      printf("# trace restarts after a reset at line %u; replay stops there\n",
+             lineNumber);
+      break;
+    }
+    unsigned long lost = 0;
+    unsigned long lostAfter = 0;
+    if (sscanf(line, "# lost %lu after %lu", &lost, &lostAfter) == 2) {
+      printf("# board dropped %lu input events after %lu ms (line %u); "
+             "replay may diverge from there\n",
+             lost, lostAfter, lineNumber);
+      continue;
+    }
+    if (line[0] == '#' || line[0] == '\n') {
+      continue;
+    }
+    Event event;
+    char kind[8];
+    unsigned pin = 0;
+    long value = 0;
+    if (sscanf(line, "%lu %7s", &event.ms, kind) != 2) {
+      fprintf(stderr, "line %u: bad event\n", lineNumber);
+      return false;
+    }
+    bool ok;
+    if (strcmp(kind, "pin") == 0 || strcmp(kind, "adc") == 0) {
+      event.kind = kind[0] == 'p' ? EVENT_PIN : EVENT_ADC;
+      ok = sscanf(line, "%*s %*s %u %ld", &pin, &value) == 2 &&
+           pin < NUM_DIGITAL_PINS;
+    } else if (strcmp(kind, "rtc") == 0) {
+      event.kind = EVENT_RTC;
+      ok = sscanf(line, "%*s %*s %ld", &value) == 1;
+    } else if (strcmp(kind, "serial") == 0) {
+      event.kind = EVENT_SERIAL;
+      ok = sscanf(line, "%*s %*s %ld", &value) == 1;
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      fprintf(stderr, "line %u: bad event\n", lineNumber);
+      return false;
+    }
+    event.pin = pin;
+    event.value = value;
+    events.push_back(event);
+  }
+  return true;
+}
+
+void apply(const Event &event) {
+  switch (event.kind) {
+  case EVENT_PIN:
+    native::pinLevel[event.pin] = event.value ? HIGH : LOW;
+    break;
+  case EVENT_ADC:
+    native::analogValue[event.pin] = event.value;
+    break;
+  case EVENT_RTC:
+    native::rtcEpoch = static_cast<uint32_t>(event.value);
+    break;
+  case EVENT_SERIAL: {
+    uint8_t data = event.value;
+    native::serialInject(&data, 1);
+    break;
+  }
+  }
+  ++applied[event.kind];
+}
+
+/**
+ * @brief Puts each input's first recorded value in place before boot
+ */
+void seedInputs() {
+  bool seen[NUM_DIGITAL_PINS * 2] = {};
+  bool rtcSeen = false;
+  for (const Event &event : events) {
+    if (event.kind == EVENT_RTC && !rtcSeen) {
+      rtcSeen = true;
+      native::rtcEpoch = static_cast<uint32_t>(event.value);
+    } else if (event.kind == EVENT_PIN || event.kind == EVENT_ADC) {
+      bool &first = seen[event.pin * 2 + event.kind];
+      if (!first) {
+        first = true;
+        if (event.kind == EVENT_PIN) {
+          native::pinLevel[event.pin] = event.value ? HIGH : LOW;
+        } else {
+          native::analogValue[event.pin] = event.value;
+        }
+      }
+    }
+  }
+}
+
+void printTime() { printf("[%10.3f] ", native::nowMicros / 1e6); }
+
+void printRecord(const std::string &payload) {
+  TelemetryHeader header;
+  if (payload.size() < sizeof(header)) {
+    ++badFrames;
+    return;
+  }
+  memcpy(&header, payload.data(), sizeof(header));
+  ++records;
+
+  switch (header.type) {
+  case TELEMETRY_PUMP: {
+    TelemetryPump pump;
+    if (payload.size() != sizeof(pump)) {
+      break;
+    }
+    memcpy(&pump, payload.data(), sizeof(pump));
+    printTime();
+    const char *reason =
+        pump.reason <= PUMP_REASON_DRY ? reasonNames[pump.reason] : "?";
+    if (pump.on) {
+      printf("pump on %s\n", reason);
+    } else {
+      printf("pump off %s %lu ms %u ml\n", reason,
+             static_cast<unsigned long>(pump.runtimeMs), pump.volumeMl);
+      ++pumpRuns;
+      pumpMs += pump.runtimeMs;
+      pumpMl += pump.volumeMl;
+    }
+    break;
+  }
+  case TELEMETRY_FAULT: {
+    TelemetryFault fault;
+    if (payload.size() != sizeof(fault)) {
+      break;
+    }
+    memcpy(&fault, payload.data(), sizeof(fault));
+    printTime();
+    printf("fault %u (#%u)\n", fault.fault, fault.count);
+    break;
+  }
+  case TELEMETRY_LCD: {
+    TelemetryLcdRow row;
+    if (payload.size() != sizeof(row)) {
+      break;
+    }
+    memcpy(&row, payload.data(), sizeof(row));
+    printTime();
+    printf("lcd %u \"%.16s\"\n", row.row, row.text);
+    break;
+  }
+  case TELEMETRY_STATUS: {
+    TelemetryStatus status;
+    if (!showStatus || payload.size() != sizeof(status)) {
+      break;
+    }
+    memcpy(&status, payload.data(), sizeof(status));
+    printTime();
+    printf("status soil %u%% (%u, %u s old) probe %u flags 0x%02x next %lu s "
+           "tank %u ml dropped %u\n",
+           status.moisturePercent, status.moistureRaw, status.moistureAgeS,
+           status.waterDetectRaw,
+           status.flags, static_cast<unsigned long>(status.secondsToWatering),
+           status.tankMl, status.droppedFrames);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief Splits Serial output on 0x00; prints records and text replies
+ */
+void drainOutput() {
+  pendingOutput += native::serialOutput();
+  size_t end;
+  while ((end = pendingOutput.find('\0')) != std::string::npos) {
+    std::string frame = pendingOutput.substr(0, end);
+    pendingOutput.erase(0, end + 1);
+    if (frame.empty()) {
+      continue;
+    }
+
+    // COBS decode, then check the CRC (high byte first)
+    std::string decoded;
+    bool ok = true;
+    for (size_t i = 0; i < frame.size() && ok;) {
+      uint8_t code = frame[i];
+      ok = code != 0 && i + code <= frame.size();
+      if (ok) {
+        decoded.append(frame, i + 1, code - 1);
+        i += code;
+        if (code < 0xFF && i < frame.size()) {
+          decoded.push_back('\0');
+        }
+      }
+    }
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; ok && decoded.size() >= 2 && i < decoded.size() - 2;
+         ++i) {
+      crc = telemetryCrc16(crc, decoded[i]);
+    }
+    if (ok && decoded.size() >= 2 &&
+        crc == (static_cast<uint8_t>(decoded[decoded.size() - 2]) << 8 |
+                static_cast<uint8_t>(decoded[decoded.size() - 1]))) {
+      decoded.resize(decoded.size() - 2);
+      printRecord(decoded);
+      continue;
+    }
+
+    // Command reply
+    size_t start = 0;
+    while (start < frame.size()) {
+      size_t lineEnd = frame.find_first_of("\r\n", start);
+      if (lineEnd == std::string::npos) {
+        lineEnd = frame.size();
+      }
+      if (lineEnd > start) {
+        printTime();
+        printf("> %s\n", frame.substr(start, lineEnd - start).c_str());
+      }
+      start = lineEnd + 1;
+    }
+  }
+}
+
+void finish() {
+  drainOutput();
+#ifdef PROFILING
+  profileDump(Serial);
+  printf("%s", native::serialOutput().c_str());
+#endif
+  printf("# replayed %lu pin, %lu adc, %lu rtc, %lu serial events\n",
+         applied[EVENT_PIN], applied[EVENT_ADC], applied[EVENT_RTC],
+         applied[EVENT_SERIAL]);
+  printf("# %lu pump runs, %lu ms, %lu ml; %lu records, %lu bad frames\n",
+         pumpRuns, pumpMs, pumpMl, records, badFrames);
+  printf("# %.1f s simulated, %.1f s on this host\n", native::nowMicros / 1e6,
+         static_cast<double>(clock()) / CLOCKS_PER_SEC);
+  exit(0);
+}
+
+void onIo(uint8_t) {
+  unsigned long now = millis();
+  while (nextEvent < events.size() && events[nextEvent].ms <= now) {
+    apply(events[nextEvent++]);
+  }
+  drainOutput();
+  if (now >= endMs) {
+    finish();
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  bool mirror = false;
+  const char *path = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--lcd") == 0) {
+      mirror = true;
+    } else if (strcmp(argv[i], "--status") == 0) {
+      showStatus = true;
+    } else {
+      path = argv[i];
+    }
+  }
+  if (!path) {
+    fprintf(stderr, "usage: %s trace-file [--lcd] [--status]\n", argv[0]);
+    return 1;
+  }
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    perror(path);
+    return 1;
+  }
+  bool loaded = loadTrace(file);
+  fclose(file);
+  if (!loaded) {
+    return 1;
+  }
+
+  native::rtcEpoch = RtcDateTime(2025, 6, 1, 8, 0, 0).TotalSeconds();
+  seedInputs();
+  endMs = (events.empty() ? 0 : events.back().ms) + tailMs;
+  native::ioHook = onIo;
+  lcd.setMirror(mirror);
+  setup();
+  while (true) {
+    loop(); // onIo finishes the run
+  }
+}
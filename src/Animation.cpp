@@ -0,0 +1,143 @@
+/**
+ * @file Animation.cpp
+ * @brief Step queue and frame timing for the LCD effects
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Steps live in a small ring (7 bytes each on AVR). A step starts the
+ * first time animationService() sees it at the head of the ring; its frames
+ * are then timed from that moment, so a late service tick draws the overdue
+ * characters at once instead of drifting the whole sequence.
+ */
+
+#include "Animation.h"
+
+namespace {
+
+struct AnimationStep {
+  const char *text; ///< nullptr: pause
+  uint8_t col;
+  uint8_t row;
+  uint8_t flags;    ///< ANIMATE_* bits
+  uint16_t holdMs;
+};
+
+const uint8_t queueSize = 8;
+
+Display *screen = nullptr;
+AnimationStep queue[queueSize];
+uint8_t head = 0;
+uint8_t count = 0;
+bool started = false;       ///< Head step has been drawn
+unsigned long stepStart = 0; ///< millis() when the head step started
+uint8_t typed = 0;          ///< Characters of a typewriter step printed
+
+/**
+ * @brief Length of the head step in ms
+ */
+unsigned long stepLength(const AnimationStep &step) {
+  if ((step.flags & ANIMATE_TYPE) && step.text != nullptr) {
+    return static_cast<unsigned long>(strlen(step.text)) * step.holdMs;
+  }
+  return step.holdMs;
+}
+
+void finish() {
+  count = 0;
+  started = false;
+  screen->noBlink();
+  screen->clear();
+}
+
+} // namespace
+
+void animationBegin(Display &display) { screen = &display; }
+
+bool animationQueue(const char *text, uint8_t col, uint8_t row, uint16_t holdMs,
+                    uint8_t flags) {
+  if (count == queueSize) {
+    return false;
+  }
+  AnimationStep &step = queue[(head + count) % queueSize];
+  step.text = text;
+  step.col = col;
+  step.row = row;
+  step.flags = flags;
+  step.holdMs = holdMs;
+  ++count;
+  return true;
+}
+
+void animationToast(const char *top, const char *bottom, uint16_t holdMs) {
+  animationQueue(top, 0, 0, 0, ANIMATE_CLEAR);
+  animationQueue(bottom, 0, 1, holdMs);
+}
+
+void animationService() {
+  while (count != 0) {
+    const AnimationStep &step = queue[head];
+    unsigned long now = millis();
+
+    if (!started) {
+      started = true;
+      stepStart = now;
+      typed = 0;
+      if (step.flags & ANIMATE_CLEAR) {
+        screen->clear();
+      }
+      screen->setCursor(step.col, step.row);
+      if (step.flags & ANIMATE_TYPE) {
+        screen->blink();
+      } else if (step.text != nullptr) {
+        screen->print(step.text);
+      }
+    }
+
+    unsigned long elapsed = now - stepStart;
+    if ((step.flags & ANIMATE_TYPE) && step.text != nullptr) {
+      // Character i is due at i * holdMs, as the old print-then-delay loop
+      while (step.text[typed] != '\0' &&
+             static_cast<unsigned long>(typed) * step.holdMs <= elapsed) {
+        screen->print(step.text[typed++]);
+      }
+    }
+    if (elapsed < stepLength(step)) {
+      return;
+    }
+
+    if (step.flags & ANIMATE_TYPE) {
+      screen->noBlink();
+    }
+    head = (head + 1) % queueSize;
+    --count;
+    started = false;
+    if (count == 0) {
+      finish();
+    }
+  }
+}
+
+bool animationActive() { return count != 0; }
+
+unsigned long animationDueIn() {
+  if (count == 0) {
+    return 0xFFFFFFFFUL;
+  }
+  if (!started) {
+    return 0;
+  }
+  const AnimationStep &step = queue[head];
+  unsigned long elapsed = millis() - stepStart;
+  unsigned long due = stepLength(step);
+  if ((step.flags & ANIMATE_TYPE) && step.text != nullptr &&
+      step.text[typed] != '\0') {
+    due = static_cast<unsigned long>(typed) * step.holdMs;
+  }
+  return elapsed < due ? due - elapsed : 0;
+}
+
+void animationSkip() {
+  if (count != 0) {
+    finish();
+  }
+}
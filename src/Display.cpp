@@ -0,0 +1,159 @@
+/**
+ * @file Display.cpp
+ * @brief RAM frame tracking, PCF8574 probe and row mirroring
+ * @author Quiyet Brul
+ * @date 2025
+ */
+
+#include "Display.h"
+
+#include <Wire.h>
+
+#include "Telemetry.h"
+
+static_assert(Hw::lcdCols <= sizeof(TelemetryLcdRow::text),
+              "LCD rows must fit a TELEMETRY_LCD record");
+static_assert(Hw::lcdRows <= 8, "dirtyRows_ holds one bit per row");
+
+Display::Display()
+#ifndef HEADLESS
+    : lcd_(Hw::lcdAddress, Hw::lcdCols, Hw::lcdRows)
+#endif
+{
+  memset(frame_, ' ', sizeof(frame_));
+  col_ = 0;
+  row_ = 0;
+  dirtyRows_ = 0;
+  present_ = false;
+  mirror_ = false;
+  lastMirror_ = 0;
+  memset(sentCrc_, 0, sizeof(sentCrc_));
+}
+
+void Display::init() {
+#ifndef HEADLESS
+  Wire.begin();
+  Wire.beginTransmission(Hw::lcdAddress);
+  present_ = Wire.endTransmission() == 0;
+  if (present_) {
+    lcd_.init();
+  }
+#endif
+  if (!present_) {
+    setMirror(true);
+  }
+}
+
+void Display::clear() {
+  for (uint8_t r = 0; r < rows; ++r) {
+    for (uint8_t c = 0; c < cols; ++c) {
+      if (frame_[r][c] != ' ') {
+        frame_[r][c] = ' ';
+        dirtyRows_ |= 1 << r;
+      }
+    }
+  }
+  col_ = 0;
+  row_ = 0;
+#ifndef HEADLESS
+  if (present_) {
+    lcd_.clear();
+  }
+#endif
+}
+
+void Display::setCursor(uint8_t col, uint8_t row) {
+  col_ = col;
+  row_ = row;
+#ifndef HEADLESS
+  if (present_) {
+    lcd_.setCursor(col, row);
+  }
+#endif
+}
+
+void Display::backlight() {
+#ifndef HEADLESS
+  if (present_) {
+    lcd_.backlight();
+  }
+#endif
+}
+
+void Display::noBacklight() {
+#ifndef HEADLESS
+  if (present_) {
+    lcd_.noBacklight();
+  }
+#endif
+}
+
+void Display::blink() {
+#ifndef HEADLESS
+  if (present_) {
+    lcd_.blink();
+  }
+#endif
+}
+
+void Display::noBlink() {
+#ifndef HEADLESS
+  if (present_) {
+    lcd_.noBlink();
+  }
+#endif
+}
+
+size_t Display::write(uint8_t c) {
+  if (row_ < rows && col_ < cols && frame_[row_][col_] != static_cast<char>(c)) {
+    frame_[row_][col_] = c;
+    dirtyRows_ |= 1 << row_;
+  }
+  ++col_;
+#ifndef HEADLESS
+  if (present_) {
+    lcd_.write(c);
+  }
+#endif
+  return 1;
+}
+
+void Display::setMirror(bool enabled) {
+  mirror_ = enabled;
+  dirtyRows_ = enabled ? (1 << rows) - 1 : 0;
+  memset(sentCrc_, 0, sizeof(sentCrc_)); // Resend every row
+}
+
+void Display::service() {
+  // Waiting for an empty ring means both rows always fit (2 x 27 bytes)
+  if (!mirror_ || dirtyRows_ == 0 || telemetryPending() ||
+      millis() - lastMirror_ < mirrorInterval) {
+    return;
+  }
+  lastMirror_ = millis();
+
+  for (uint8_t r = 0; r < rows; ++r) {
+    if (!(dirtyRows_ & (1 << r))) {
+      continue;
+    }
+    uint16_t crc = 0xFFFF;
+    for (uint8_t c = 0; c < cols; ++c) {
+      crc = telemetryCrc16(crc, frame_[r][c]);
+    }
+    if (crc == sentCrc_[r]) {
+      dirtyRows_ &= ~(1 << r); // Redrawn with the same text
+      continue;
+    }
+
+    TelemetryLcdRow record;
+    telemetryHeader(record.header, TELEMETRY_LCD);
+    record.row = r;
+    memset(record.text, ' ', sizeof(record.text));
+    memcpy(record.text, frame_[r], cols);
+    if (!telemetrySend(&record, sizeof(record))) {
+      return;
+    }
+    sentCrc_[r] = crc;
+    dirtyRows_ &= ~(1 << r);
+  }
+}
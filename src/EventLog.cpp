@@ -0,0 +1,229 @@
+/**
+ * @file EventLog.cpp
+ * @brief DS1302 RAM hot tail flushed in batches to an EEPROM ring
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Hot tail image (all 31 bytes of RTC RAM, written in one burst):
+ * magic, count, eventLogBatch packed records, CRC-8 of everything before it.
+ * A tail that fails the check (battery replaced, first boot) starts empty.
+ * A batch is written to the EEPROM before the tail is emptied, so a power cut
+ * in between can repeat a batch but never lose one.
+ */
+
+#include "EventLog.h"
+#include "Recorder.h"
+#include "Supervisor.h"
+#include "Telemetry.h"
+
+#include <EEPROM.h>
+
+namespace {
+
+const uint8_t recordSize = 7;
+const uint8_t tailMagic = 0xEC;
+const uint8_t lapBit = 0x80;
+const uint8_t erasedKind = 0x7F; ///< Kind byte of an erased slot, lap aside
+
+/**
+ * @brief Hot tail exactly as stored in RTC RAM
+ */
+struct __attribute__((packed)) HotTail {
+  uint8_t magic;
+  uint8_t count;
+  uint8_t records[eventLogBatch][recordSize];
+  uint8_t crc;
+};
+
+static_assert(sizeof(HotTail) <= 31, "Hot tail must fit DS1302 RAM");
+static_assert(eventLogEepromBase + eventLogSlots * recordSize <= 1024,
+              "Event ring must fit the ATmega328P EEPROM");
+
+RtcDS1302<ThreeWire> *rtcClock = nullptr;
+HotTail tail;
+uint8_t head = 0;      ///< Next ring slot to write
+uint8_t writeLap = 0;  ///< Lap bit for records written this lap
+uint8_t ringCount = 0; ///< Valid records in the ring
+
+/**
+ * @brief CRC-8 (poly 0x07) over a byte range
+ */
+uint8_t crc8(const uint8_t *data, uint8_t size) {
+  uint8_t crc = 0;
+  while (size--) {
+    crc ^= *data++;
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+void pack(const EventRecord &record, uint8_t *out) {
+  out[0] = record.kind;
+  out[1] = record.detail;
+  out[2] = record.value;
+  out[3] = record.value >> 8;
+  out[4] = record.minutes;
+  out[5] = record.minutes >> 8;
+  out[6] = record.minutes >> 16;
+}
+
+void unpack(const uint8_t *in, EventRecord &record) {
+  record.kind = in[0] & ~lapBit;
+  record.detail = in[1];
+  record.value = in[2] | (uint16_t)in[3] << 8;
+  record.minutes = in[4] | (uint32_t)in[5] << 8 | (uint32_t)in[6] << 16;
+}
+
+int slotAddress(uint8_t slot) {
+  return eventLogEepromBase + slot * recordSize;
+}
+
+void saveTail() {
+  tail.magic = tailMagic;
+  tail.crc = crc8(reinterpret_cast<const uint8_t *>(&tail),
+                  sizeof(tail) - 1);
+  rtcClock->SetMemory(reinterpret_cast<const uint8_t *>(&tail), sizeof(tail));
+}
+
+/**
+ * @brief Appends the full hot tail to the ring
+ */
+void flushTail() {
+  for (uint8_t i = 0; i < tail.count; ++i) {
+    tail.records[i][0] |= writeLap;
+    int address = slotAddress(head);
+    for (uint8_t b = 0; b < recordSize; ++b) {
+      EEPROM.update(address + b, tail.records[i][b]);
+    }
+    if (++head == eventLogSlots) {
+      head = 0;
+      writeLap ^= lapBit;
+    }
+    if (ringCount < eventLogSlots) {
+      ++ringCount;
+    }
+  }
+  tail.count = 0;
+}
+
+} // namespace
+
+void eventLogBegin(RtcDS1302<ThreeWire> &rtc) {
+  rtcClock = &rtc;
+  if (rtcClock->GetIsWriteProtected()) {
+    rtcClock->SetIsWriteProtected(false);
+  }
+
+  rtcClock->GetMemory(reinterpret_cast<uint8_t *>(&tail), sizeof(tail));
+  if (tail.magic != tailMagic || tail.count > eventLogBatch ||
+      tail.crc != crc8(reinterpret_cast<const uint8_t *>(&tail),
+                       sizeof(tail) - 1)) {
+    tail.count = 0;
+    saveTail();
+  }
+
+  // The head is the first slot whose lap bit differs from slot 0's
+  uint8_t firstLap = EEPROM.read(slotAddress(0)) & lapBit;
+  head = 0;
+  writeLap = firstLap ^ lapBit;
+  ringCount = 0;
+  for (uint8_t slot = 0; slot < eventLogSlots; ++slot) {
+    uint8_t kind = EEPROM.read(slotAddress(slot));
+    if ((kind & lapBit) != firstLap && head == 0 && slot != 0) {
+      head = slot;
+      writeLap = firstLap;
+    }
+    if ((kind & ~lapBit) != erasedKind) {
+      ++ringCount;
+    }
+  }
+}
+
+void eventLogAdd(EventKind kind, uint8_t detail, uint16_t value) {
+  if (rtcClock == nullptr) {
+    return;
+  }
+  EventRecord record;
+  record.kind = kind;
+  record.detail = detail;
+  record.value = value;
+  uint32_t seconds = rtcClock->GetDateTime().TotalSeconds();
+  RECORD_RTC(seconds);
+  record.minutes =
+      seconds > eventLogEpoch ? (seconds - eventLogEpoch) / 60UL : 0;
+
+  if (tail.count == eventLogBatch) {
+    flushTail();
+  }
+  pack(record, tail.records[tail.count++]);
+  saveTail();
+}
+
+uint8_t eventLogCount() { return ringCount + tail.count; }
+
+bool eventLogGet(uint8_t age, EventRecord &record) {
+  if (age < tail.count) {
+    unpack(tail.records[tail.count - 1 - age], record);
+    return true;
+  }
+  age -= tail.count;
+  if (age >= ringCount) {
+    return false;
+  }
+  uint8_t slot = (head + eventLogSlots - 1 - age) % eventLogSlots;
+  uint8_t bytes[recordSize];
+  for (uint8_t b = 0; b < recordSize; ++b) {
+    bytes[b] = EEPROM.read(slotAddress(slot) + b);
+  }
+  unpack(bytes, record);
+  return true;
+}
+
+void eventLogDescribe(const EventRecord &record, char *text, uint8_t size) {
+  static const char *const reasons[] = {"man", "auto", "cal", "ser", "dry"};
+  static const char *const faults[] = {"?", "hang", "pump time", "dry run"};
+
+  switch (record.kind) {
+  case EVENT_BOOT:
+    if (record.detail == FAULT_WATCHDOG) {
+      snprintf_P(text, size, PSTR("Boot: WDT reset"));
+    } else {
+      snprintf_P(text, size, PSTR("Boot"));
+    }
+    break;
+  case EVENT_WATERED:
+    snprintf_P(text, size, PSTR("Water %uml %s"), record.value,
+               reasons[record.detail <= PUMP_REASON_DRY ? record.detail : 0]);
+    break;
+  case EVENT_SKIP_TANK:
+    snprintf_P(text, size, PSTR("Skip: tank low"));
+    break;
+  case EVENT_SKIP_WET:
+    snprintf_P(text, size, PSTR("Skip: wet %u%%"), record.value);
+    break;
+  case EVENT_SKIP_SPILL:
+    snprintf_P(text, size, PSTR("Skip: spill %u"), record.value);
+    break;
+  case EVENT_FAULT:
+    snprintf_P(text, size, PSTR("Fault: %s"),
+               faults[record.detail <= FAULT_PUMP_DRY ? record.detail : 0]);
+    break;
+  case EVENT_TANK_LOW:
+    snprintf_P(text, size, PSTR("Tank low"));
+    break;
+  case EVENT_REFILLED:
+    snprintf_P(text, size, PSTR("Tank refilled"));
+    break;
+  default:
+    snprintf_P(text, size, PSTR("Event %u"), record.kind);
+    break;
+  }
+}
+
+void eventLogFormatTime(const EventRecord &record, char *text, uint8_t size) {
+  RtcDateTime time(eventLogEpoch + record.minutes * 60UL);
+  snprintf_P(text, size, PSTR("%04u-%02u-%02u %02u:%02u"), time.Year(),
+             time.Month(), time.Day(), time.Hour(), time.Minute());
+}
@@ -0,0 +1,74 @@
+/**
+ * @file FlowMeter.cpp
+ * @brief PCINT1 edge counter for the flow sensor
+ * @author Quiyet Brul
+ * @date 2025
+ */
+
+#include "FlowMeter.h"
+#include "HardwareProfile.h"
+#include "Pin.h"
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#endif
+
+static_assert(Hw::flowMeter >= A0 && Hw::flowMeter <= A5,
+              "Flow meter expects a PORTC pin (PCINT1)");
+
+namespace {
+
+typedef Pin<Hw::flowMeter> FlowInput;
+
+#if defined(__AVR__)
+volatile uint32_t pulseCount = 0;
+volatile bool lastLevel = false;
+#else
+const double simulatedLitresPerMinute = 1.2; ///< Small diaphragm pump
+#endif
+
+} // namespace
+
+#if defined(__AVR__)
+ISR(PCINT1_vect) {
+  bool level = FlowInput::read();
+  if (level && !lastLevel) {
+    ++pulseCount;
+  }
+  lastLevel = level;
+}
+#endif
+
+void flowBegin() {
+  if (!Hw::hasFlowMeter) {
+    return;
+  }
+  FlowInput::inputPullup();
+#if defined(__AVR__)
+  lastLevel = FlowInput::read();
+  PCMSK1 |= _BV(Hw::flowMeter - A0);
+  PCIFR = _BV(PCIF1);
+  PCICR |= _BV(PCIE1);
+#else
+  if (!native::hasPulseSource(Hw::flowMeter)) {
+    native::pulseSource(Hw::flowMeter, Hw::pump,
+                        simulatedLitresPerMinute * Hw::flowPulsesPerLitre /
+                            60.0);
+  }
+#endif
+}
+
+uint32_t flowPulses() {
+#if defined(__AVR__)
+  uint32_t count;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { count = pulseCount; }
+  return count;
+#else
+  return native::pulseCount(Hw::flowMeter);
+#endif
+}
+
+uint16_t flowPulsesToMillilitres(uint32_t pulses) {
+  return pulses * 1000UL / Hw::flowPulsesPerLitre;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file ManualPump.cpp
+ * @brief Button-edge pump switching for manual mode
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details State shared with the interrupt is only changed with interrupts
+ * off, so a press and a forced stop cannot interleave.
+ */
+
+#include "ManualPump.h"
+
+#include "HardwareProfile.h"
+#include "Pin.h"
+#include "Power.h"
+#include "PumpDrive.h"
+
+#if defined(__AVR__)
+#include <util/atomic.h>
+#define MANUAL_ATOMIC ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#else
+#define MANUAL_ATOMIC
+#endif
+
+namespace {
+
+typedef Pin<Hw::buttonM> ButtonM;
+typedef Pin<Hw::floatSwitch> WaterLevelSwitch;
+typedef Pin<Hw::pumpValve> PumpValve;
+
+uint8_t pumpPwm = 0;
+volatile bool armed = false;
+volatile bool on = false;
+volatile bool latched = false; ///< Forced off until (M) is released
+volatile unsigned long changedAt = 0;
+
+void switchOff() {
+  pumpDriveStop();
+  if (Hw::hasValve) {
+    PumpValve::low();
+  }
+  on = false;
+  changedAt = millis();
+}
+
+/**
+ * @brief Follows (M); runs in the pin-change interrupt
+ */
+void onEdge() {
+  if (millis() - changedAt < Hw::debounceDuration) {
+    return; // bounce; manualPumpPoll() catches up once it has settled
+  }
+  bool pressed = ButtonM::isLow();
+  if (!pressed) {
+    latched = false;
+    if (on) {
+      switchOff();
+    }
+    return;
+  }
+  bool tankOk = !Hw::hasFloatSwitch || WaterLevelSwitch::isLow();
+  if (!on && armed && !latched && tankOk) {
+    if (Hw::hasValve) {
+      PumpValve::high();
+    }
+    pumpDriveSet(pumpPwm);
+    on = true;
+    changedAt = millis();
+  }
+}
+
+} // namespace
+
+void manualPumpBegin(uint8_t pwm) {
+  MANUAL_ATOMIC {
+    pumpPwm = pwm;
+    armed = false;
+    on = false;
+    latched = ButtonM::isLow(); // (M) still down from opening the screen
+  }
+  powerButtonHook(onEdge);
+}
+
+void manualPumpArm(bool safe) {
+  MANUAL_ATOMIC {
+    armed = safe;
+    if (!safe && on) {
+      switchOff();
+    }
+  }
+}
+
+void manualPumpPoll() {
+  MANUAL_ATOMIC { onEdge(); }
+}
+
+bool manualPumpOn() { return on; }
+
+unsigned long manualPumpChangedAt() {
+  unsigned long at;
+  MANUAL_ATOMIC { at = changedAt; }
+  return at;
+}
+
+void manualPumpStop() {
+  MANUAL_ATOMIC {
+    latched = true;
+    if (on) {
+      switchOff();
+    }
+  }
+}
+
+void manualPumpEnd() {
+  powerButtonHook(nullptr);
+  manualPumpStop();
+}
@@ -0,0 +1,101 @@
+/**
+ * @file MemoryMonitor.cpp
+ * @brief SRAM canary painting and malloc free-list walk
+ * @author Quiyet Brul
+ * @date 2025
+ */
+
+#include "MemoryMonitor.h"
+
+#if defined(__AVR__)
+
+namespace {
+const uint8_t canary = 0xC5;
+}
+
+/**
+ * @brief Layout of an avr-libc free-list entry (stdlib_private.h)
+ */
+struct __freelist {
+  size_t sz;
+  struct __freelist *nx;
+};
+
+extern uint8_t _end;               // linker: end of .bss/.noinit
+extern char *__brkval;             // malloc: current heap top (0 = unused)
+extern char *__malloc_heap_start;  // malloc: heap base
+extern struct __freelist *__flp;   // malloc: free-list head
+
+/**
+ * @brief Paints the stack/heap gap with the canary at reset
+ * @details Runs from .init3: the stack pointer is set up but nothing has been
+ * pushed yet, and .data/.bss are initialised afterwards, below _end.
+ */
+extern "C" void memoryPaintStack() __attribute__((naked, used, section(".init3")));
+
+void memoryPaintStack() {
+  uint8_t *p = &_end;
+  while (p <= reinterpret_cast<uint8_t *>(RAMEND)) {
+    *p++ = canary;
+  }
+}
+
+void memoryStats(MemoryStats &stats) {
+  uint8_t *heapTop = reinterpret_cast<uint8_t *>(
+      __brkval != 0 ? __brkval : __malloc_heap_start);
+  uint8_t *stackPointer = reinterpret_cast<uint8_t *>(SP);
+
+  uint8_t *p = heapTop;
+  while (p < stackPointer && *p == canary) {
+    ++p;
+  }
+  stats.stackHeadroom = p - heapTop;
+  stats.stackPeak = reinterpret_cast<uint8_t *>(RAMEND) - p + 1;
+  stats.freeNow = stackPointer - heapTop;
+  stats.heapSize = heapTop - reinterpret_cast<uint8_t *>(__malloc_heap_start);
+
+  stats.heapFree = 0;
+  stats.heapLargest = 0;
+  stats.heapBlocks = 0;
+  for (struct __freelist *block = __flp; block != 0; block = block->nx) {
+    uint16_t size = block->sz + sizeof(size_t);
+    stats.heapFree += size;
+    stats.heapLargest = max(stats.heapLargest, size);
+    ++stats.heapBlocks;
+  }
+}
+
+#else
+
+// The host has no fixed SRAM map to scan; report an empty snapshot
+void memoryStats(MemoryStats &stats) { memset(&stats, 0, sizeof(stats)); }
+
+#endif
+
+uint8_t memoryFragmentation(const MemoryStats &stats) {
+  if (stats.heapFree == 0) {
+    return 0;
+  }
+  return 100 - (uint32_t)stats.heapLargest * 100 / stats.heapFree;
+}
+
+void memoryReport(Print &out) {
+  MemoryStats stats;
+  memoryStats(stats);
+
+  out.print(F("MEM stack_peak="));
+  out.print(stats.stackPeak);
+  out.print(F(" headroom="));
+  out.print(stats.stackHeadroom);
+  out.print(F(" free="));
+  out.print(stats.freeNow);
+  out.print(F(" heap="));
+  out.print(stats.heapSize);
+  out.print(F(" heap_free="));
+  out.print(stats.heapFree);
+  out.print('/');
+  out.print(stats.heapBlocks);
+  out.print(F(" frag="));
+  out.print(memoryFragmentation(stats));
+  out.println('%');
+}
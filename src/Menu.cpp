@@ -0,0 +1,192 @@
+/**
+ * @file Menu.cpp
+ * @brief Generic engine for the PROGMEM menu tables
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Only the current item is copied out of flash, when it opens, and its
+ * run-time range is folded into that copy. The value being edited lives here
+ * until (M) stores it, so a cancelled edit leaves the variable as it was.
+ */
+
+#include "Menu.h"
+
+#include "Animation.h"
+
+namespace {
+
+const uint8_t repeatStages =
+    sizeof(menuRepeatCurve) / sizeof(menuRepeatCurve[0]);
+
+Display *screen = nullptr;
+const MenuItem *table = nullptr; ///< PROGMEM; nullptr when closed
+uint8_t itemCount = 0;
+uint8_t current = 0;             ///< Item being edited, or list entry shown
+MenuItem item;                   ///< RAM copy of table[current]
+const char *listTitle = nullptr;
+int16_t editValue = 0;           ///< Number being edited
+bool dirty = true;               ///< LCD needs redrawing
+int8_t repeatDirection = 0;      ///< -1/+1 while (-)/(+) repeats, else 0
+unsigned long pressedAt = 0;     ///< millis() of the press being repeated
+unsigned long lastRepeat = 0;    ///< millis() of its last step
+
+void load(uint8_t i) {
+  current = i;
+  memcpy_P(&item, &table[i], sizeof(item));
+  if (item.type == MENU_NUMBER) {
+    if (item.range != nullptr) {
+      item.minValue = max(item.minValue, item.range->minValue);
+      item.maxValue = min(item.maxValue, item.range->maxValue);
+      item.step = item.range->step;
+    }
+    editValue = constrain(*item.value, item.minValue, item.maxValue);
+  }
+  dirty = true;
+}
+
+void printValue() {
+  if (item.valueText != nullptr) {
+    screen->print(item.valueText(editValue));
+    return;
+  }
+  int16_t divisor = item.decimals == 0 ? 1 : item.decimals == 1 ? 10 : 100;
+  if (editValue < 0) {
+    screen->print('-');
+  }
+  unsigned int magnitude = editValue < 0 ? -editValue : editValue;
+  screen->print(magnitude / divisor);
+  if (item.decimals != 0) {
+    unsigned int fraction = magnitude % divisor;
+    screen->print('.');
+    if (item.decimals == 2 && fraction < 10) {
+      screen->print('0');
+    }
+    screen->print(fraction);
+  }
+}
+
+void draw() {
+  screen->clear();
+  screen->setCursor(0, 0);
+  if (item.type == MENU_ACTION) {
+    if (listTitle != nullptr) {
+      screen->print(listTitle);
+    }
+    screen->setCursor(0, 1);
+    screen->print(item.text);
+  } else {
+    screen->print(item.text);
+    screen->setCursor(0, 1);
+    screen->print(item.label);
+    printValue();
+  }
+  dirty = false;
+}
+
+/**
+ * @brief Moves the value or selection
+ * @param direction -1 or +1, times the steps to move a number by
+ */
+void change(int8_t direction) {
+  if (item.type == MENU_ACTION) {
+    uint8_t next = direction < 0 ? (current == 0 ? itemCount - 1 : current - 1)
+                                 : (current + 1) % itemCount;
+    load(next);
+    return;
+  }
+  // int32_t: a step may carry the value past int16_t before it is clamped
+  int32_t next = editValue + static_cast<int32_t>(direction) * item.step;
+  if (next < item.minValue) {
+    next = item.minValue;
+  } else if (next > item.maxValue) {
+    next = item.maxValue;
+  }
+  if (next != editValue) {
+    editValue = next;
+    dirty = true;
+  }
+}
+
+/**
+ * @brief Steps a held (-)/(+) when the repeat curve says it is due
+ */
+void repeat() {
+  unsigned long now = millis();
+  unsigned long heldMs = now - pressedAt;
+  uint8_t stage = 0;
+  while (stage + 1 < repeatStages &&
+         heldMs >= menuRepeatCurve[stage + 1].heldMs) {
+    ++stage;
+  }
+  if (now - lastRepeat >= menuRepeatCurve[stage].periodMs) {
+    lastRepeat = now;
+    change(repeatDirection * menuRepeatCurve[stage].steps);
+  }
+}
+
+} // namespace
+
+void menuBegin(Display &display) { screen = &display; }
+
+void menuOpen(const MenuItem *items, uint8_t count, const char *title) {
+  table = items;
+  itemCount = count;
+  listTitle = title;
+  load(0);
+}
+
+MenuResult menuPoll(MenuKey key, bool held) {
+  if (table == nullptr) {
+    return MENU_DONE;
+  }
+  if (animationActive()) {
+    if (key != MENU_KEY_NONE) {
+      animationSkip();
+    }
+    dirty = true;
+    return MENU_RUNNING;
+  }
+
+  if (!held || key != MENU_KEY_NONE) {
+    repeatDirection = 0;
+  }
+  switch (key) {
+  case MENU_KEY_MINUS:
+  case MENU_KEY_PLUS:
+    change(key == MENU_KEY_MINUS ? -1 : 1);
+    if (held && item.type == MENU_NUMBER) {
+      repeatDirection = key == MENU_KEY_MINUS ? -1 : 1;
+      pressedAt = lastRepeat = millis();
+    }
+    break;
+  case MENU_KEY_OK:
+    if (item.type == MENU_ACTION) {
+      table = nullptr;
+      item.apply();
+      return MENU_DONE;
+    }
+    *item.value = editValue;
+    if (item.apply != nullptr) {
+      item.apply();
+    }
+    if (current + 1 == itemCount) {
+      table = nullptr;
+      return MENU_DONE;
+    }
+    load(current + 1);
+    break;
+  case MENU_KEY_BACK:
+    table = nullptr;
+    return MENU_CANCELLED;
+  case MENU_KEY_NONE:
+    if (repeatDirection != 0) {
+      repeat();
+    }
+    break;
+  }
+
+  if (dirty) {
+    draw();
+  }
+  return MENU_RUNNING;
+}
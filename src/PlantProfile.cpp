@@ -0,0 +1,77 @@
+/**
+ * @file PlantProfile.cpp
+ * @brief Plant profile library and the resolved active profile
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Percentages become raw counts with the same scale as
+ * calculateMoisture() (Hw::dryValue = 0%, Hw::wetValue = 100%), rounded up, so
+ * `raw >= plant.wetRaw` holds exactly when the reading shows as wetPercent or
+ * more.
+ */
+
+#include "PlantProfile.h"
+
+#include "HardwareProfile.h"
+
+namespace {
+
+/**
+ * @brief The library; entry 0 is selected at boot
+ * @details Doses must fit the LCD's 0.5-10 cup range (118-2370 ml).
+ */
+constexpr PlantProfile library[] PROGMEM = {
+    {"Generic", 0, 70, 2370, 60, plantHours(0, 24)},
+    {"Succulent", 10, 35, 250, 4320, plantHours(6, 10)},
+    {"Herbs", 35, 65, 400, 720, plantHours(6, 10)},
+    {"Tomato/Pepper", 45, 75, 1500, 360,
+     plantHours(5, 9) | plantHours(17, 20)},
+    {"Fern", 55, 85, 350, 240, plantHours(6, 20)},
+    {"Seedlings", 50, 75, 120, 120, plantHours(6, 18)},
+};
+
+static_assert(sizeof(library) / sizeof(library[0]) == plantProfileCount,
+              "plantProfileCount out of date");
+
+/**
+ * @brief Probe reading at which the moisture shows as percent
+ * @param percent Moisture (%), 0 for "never" (no reading is below it)
+ */
+uint16_t rawForPercent(uint8_t percent) {
+  if (percent == 0) {
+    return 0;
+  }
+  const uint16_t span = Hw::wetValue - Hw::dryValue;
+  return Hw::dryValue + (static_cast<uint32_t>(span) * percent + 99) / 100;
+}
+
+} // namespace
+
+ActivePlant plant;
+
+void plantSelect(uint8_t index) {
+  if (index >= plantProfileCount) {
+    index = 0;
+  }
+  PlantProfile profile;
+  memcpy_P(&profile, &library[index], sizeof(profile));
+  plant.dryRaw = rawForPercent(profile.moistureLow);
+  plant.maxDoseMl = profile.maxDoseMl;
+  plant.minSpacingMs = profile.minSpacingMin * 60000UL;
+  plant.preferredHours = profile.preferredHours;
+  plant.minSpacingMin = profile.minSpacingMin;
+  plant.index = index;
+  plantSetWetPercent(profile.moistureHigh);
+}
+
+void plantSetWetPercent(uint8_t percent) {
+  plant.wetRaw = rawForPercent(percent);
+  plant.wetPercent = percent;
+}
+
+const char *plantName(uint8_t index) {
+  static char name[sizeof(PlantProfile::name)];
+  strncpy_P(name, library[index].name, sizeof(name) - 1);
+  name[sizeof(name) - 1] = '\0';
+  return name;
+}
@@ -0,0 +1,382 @@
+/**
+ * @file Power.cpp
+ * @brief Watchdog-timed power-down sleep and idle naps
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details The watchdog runs in interrupt-only mode while asleep and is handed
+ * back to the supervisor (reset mode) on wake. Its RC oscillator is only
+ * accurate to ~10%, so the period is measured against micros() at boot and
+ * that measurement is what gets credited to millis(). A button wake part-way
+ * through a period is credited with half a period.
+ *
+ * The comparator borrows the ADC mux while armed, so it is armed only around
+ * a sleep and the ADC is back on before anything else can call analogRead().
+ * The RX pin change is armed the same way: while awake, every bit of every
+ * received byte would run the button interrupt.
+ */
+
+#include "Power.h"
+#include "HardwareProfile.h"
+#include "Supervisor.h"
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+extern "C" volatile unsigned long timer0_millis; // Arduino core (wiring.c)
+#endif
+
+static_assert(Hw::buttonMinus < 8 && Hw::buttonPlus < 8 && Hw::buttonM < 8 &&
+                  Hw::buttonA < 8,
+              "Button wake expects every button on PORTD (PCINT2)");
+static_assert(!Hw::hasSoilComparator || (Hw::rtcDat != 6 && Hw::rtcClk != 6 &&
+                                         Hw::rtcRst != 6),
+              "Soil wake needs D6 (AIN0) for its reference divider");
+
+namespace {
+
+const uint8_t buttonMask = (1 << Hw::buttonMinus) | (1 << Hw::buttonPlus) |
+                           (1 << Hw::buttonM) | (1 << Hw::buttonA);
+const uint8_t rxMask = 1 << 0; ///< PD0 (RXD), PCINT16
+const unsigned long serialAwakeMs = 30000UL; ///< Idle only after Serial input
+const uint8_t longestPrescale = 9; ///< 16 ms << 9 = ~8 s
+
+unsigned long watchdogTickMicros = 16000UL; ///< Measured 16 ms period
+volatile uint8_t watchdogTicks = 0;
+volatile bool watchdogTiming = false; ///< Watchdog borrowed from supervisor
+volatile bool buttonWake = false;
+void (*volatile buttonHook)() = nullptr;
+bool keepSerialAwake = false;
+volatile bool serialWake = false; ///< Start bit seen in power-down
+unsigned long serialSeenAt = 0;   ///< millis() of the last Serial wake
+bool soilWatch = false;           ///< powerSoilWake() setting
+volatile bool soilWake = false;   ///< Soil crossed while watched
+
+#ifdef POWER_BENCHMARK
+unsigned long sleptMillis = 0;     ///< Time credited while asleep
+unsigned long sleepCount = 0;      ///< Completed power-down sleeps
+unsigned long buttonWakeCount = 0; ///< Sleeps ended by a button
+unsigned long wakeLatencyTotal = 0;
+unsigned long wakeLatencyMax = 0;
+volatile unsigned long buttonWakeMicros = 0; ///< micros() in the PCINT ISR
+#endif
+
+bool isAnyButtonHeld() {
+#if defined(__AVR__)
+  return (PIND & buttonMask) != buttonMask;
+#else
+  return digitalRead(Hw::buttonMinus) == LOW ||
+         digitalRead(Hw::buttonPlus) == LOW ||
+         digitalRead(Hw::buttonM) == LOW || digitalRead(Hw::buttonA) == LOW;
+#endif
+}
+
+#if defined(__AVR__)
+/**
+ * @brief Starts the watchdog in interrupt-only mode
+ * @param prescale Period as 16 ms << prescale (0-9)
+ * @details Must be called with interrupts disabled (timed sequence).
+ */
+void watchdogInterruptMode(uint8_t prescale) {
+  watchdogTiming = true;
+  wdt_reset();
+  MCUSR &= ~_BV(WDRF);
+  WDTCSR = _BV(WDCE) | _BV(WDE);
+  WDTCSR = _BV(WDIE) | (prescale & 0x07) | ((prescale & 0x08) ? _BV(WDP3) : 0);
+}
+
+/**
+ * @brief Returns the watchdog to the supervisor; interrupts disabled
+ */
+void watchdogRelease() {
+  watchdogTiming = false;
+  supervisorWatchdogResume();
+}
+
+/**
+ * @brief Compares the soil channel against AIN0; interrupts disabled
+ * @details The output rises when the soil reads below the reference.
+ */
+void comparatorArm() {
+  soilWake = false;
+  ADCSRA &= ~_BV(ADEN); // the mux feeds the comparator only with the ADC off
+  ADCSRB |= _BV(ACME);
+  ADMUX = (ADMUX & 0xF0) | (Hw::soilRead - A0);
+  ACSR = _BV(ACIS1) | _BV(ACIS0);
+  ACSR |= _BV(ACI);
+  ACSR |= _BV(ACIE);
+}
+
+/**
+ * @brief Turns the comparator off and gives the mux back to the ADC
+ * @details A crossing during power-down only shows on the output: the
+ * interrupt could not run.
+ */
+void comparatorRelease() {
+  if (ACSR & _BV(ACO)) {
+    soilWake = true;
+  }
+  ACSR &= ~_BV(ACIE);
+  ACSR = _BV(ACD) | _BV(ACI);
+  ADCSRB &= ~_BV(ACME);
+  ADCSRA |= _BV(ADEN);
+}
+#else
+/**
+ * @brief Polled stand-in for the comparator
+ */
+bool soilBelowReference() {
+  if (analogRead(Hw::soilRead) < Hw::soilWakeRaw) {
+    soilWake = true;
+  }
+  return soilWake;
+}
+#endif
+
+} // namespace
+
+#if defined(__AVR__)
+ISR(WDT_vect) {
+  if (!watchdogTiming) {
+    supervisorWatchdogExpired(); // does not return
+  }
+  ++watchdogTicks;
+}
+
+ISR(PCINT2_vect) {
+  if ((PCMSK2 & rxMask) && !(PIND & rxMask)) {
+    serialWake = true; // the USART was stopped: this byte is lost
+    return;
+  }
+  buttonWake = true;
+  if (buttonHook != nullptr) {
+    buttonHook();
+  }
+#ifdef POWER_BENCHMARK
+  buttonWakeMicros = micros();
+#endif
+}
+
+ISR(ANALOG_COMP_vect) {
+  ACSR &= ~_BV(ACIE); // once per sleep; the reading may hover at the edge
+  soilWake = true;
+}
+#endif
+
+void powerBegin() {
+#if defined(__AVR__)
+  PCMSK2 |= buttonMask;
+  PCIFR = _BV(PCIF2);
+  PCICR |= _BV(PCIE2);
+  if (Hw::hasSoilComparator) {
+    DIDR1 |= _BV(AIN0D); // analog only; saves the input buffer's current
+    ACSR = _BV(ACD) | _BV(ACI);
+  }
+
+  cli();
+  watchdogTicks = 0;
+  watchdogInterruptMode(0);
+  sei();
+  while (watchdogTicks == 0) {
+  }
+  unsigned long start = micros();
+  uint8_t ticks = watchdogTicks;
+  while (watchdogTicks == ticks) {
+  }
+  watchdogTickMicros = micros() - start;
+  cli();
+  watchdogRelease();
+  sei();
+#endif
+}
+
+void powerSleep(unsigned long maxMs) {
+  if (maxMs * 1000UL < watchdogTickMicros || isAnyButtonHeld()) {
+    powerNap();
+    return;
+  }
+
+  uint8_t prescale = 0;
+  while (prescale < longestPrescale &&
+         (watchdogTickMicros << (prescale + 1)) / 1000UL <= maxMs) {
+    ++prescale;
+  }
+  unsigned long periodMicros = watchdogTickMicros << prescale;
+
+  if (serialWake || Serial.available()) {
+    serialWake = false;
+    serialSeenAt = millis();
+  }
+  if (keepSerialAwake || millis() - serialSeenAt < serialAwakeMs) {
+    // Idle naps keep Timer0 and the USART running; no millis() credit needed.
+    // The supervisor watchdog keeps running, so stay well inside its period.
+    if (prescale == longestPrescale) {
+      periodMicros >>= 1;
+    }
+    unsigned long start = millis();
+#if defined(__AVR__)
+    if (soilWatch) {
+      cli();
+      comparatorArm();
+      sei();
+    }
+    while (millis() - start < periodMicros / 1000UL && !Serial.available() &&
+           !isAnyButtonHeld() && !(soilWatch && soilWake)) {
+      powerNap();
+    }
+    if (soilWatch) {
+      cli();
+      comparatorRelease();
+      sei();
+    }
+#else
+    soilWake = false;
+    while (millis() - start < periodMicros / 1000UL && !Serial.available() &&
+           !isAnyButtonHeld() && !(soilWatch && soilBelowReference())) {
+      powerNap();
+    }
+#endif
+    if (Serial.available()) {
+      serialSeenAt = millis(); // still talking: keep listening
+    }
+    return;
+  }
+
+#if defined(__AVR__)
+  Serial.flush(); // the USART stops in power-down
+  cli();
+  if (isAnyButtonHeld()) {
+    sei();
+    return;
+  }
+  buttonWake = false;
+  if (soilWatch) {
+    comparatorArm();
+  }
+  PCMSK2 |= rxMask;
+  watchdogTicks = 0;
+  watchdogInterruptMode(prescale);
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+  sleep_bod_disable();
+  sei();
+  sleep_cpu();
+  sleep_disable();
+#ifdef POWER_BENCHMARK
+  unsigned long resumedMicros = micros();
+#endif
+
+  cli();
+  watchdogRelease();
+  PCMSK2 &= ~rxMask;
+  if (soilWatch) {
+    comparatorRelease();
+  }
+  unsigned long sleptMicros =
+      watchdogTicks != 0 ? periodMicros : periodMicros / 2;
+  timer0_millis += sleptMicros / 1000UL;
+  sei();
+#else
+  // Polled stand-in for the pin-change wakes, 1 ms resolution. The byte that
+  // ends the sleep is kept here, where the board loses it.
+  unsigned long sleptMicros = 0;
+  buttonWake = false;
+  soilWake = false;
+  while (sleptMicros < periodMicros) {
+    if (isAnyButtonHeld()) {
+      buttonWake = true;
+      break;
+    }
+    if (Serial.available()) {
+      serialWake = true;
+      break;
+    }
+    if (soilWatch && soilBelowReference()) {
+      break;
+    }
+    delay(1);
+    sleptMicros += 1000UL;
+  }
+#endif
+
+#ifdef POWER_BENCHMARK
+  sleptMillis += sleptMicros / 1000UL;
+  ++sleepCount;
+  if (buttonWake) {
+    ++buttonWakeCount;
+#if defined(__AVR__)
+    unsigned long latency = resumedMicros - buttonWakeMicros;
+    wakeLatencyTotal += latency;
+    if (latency > wakeLatencyMax) {
+      wakeLatencyMax = latency;
+    }
+#endif
+  }
+#endif
+}
+
+void powerKeepSerialAwake(bool enabled) { keepSerialAwake = enabled; }
+
+void powerNap() {
+#if defined(__AVR__)
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  sleep_cpu();
+  sleep_disable();
+#else
+  delay(1); // next Timer0 overflow
+#endif
+}
+
+void powerButtonHook(void (*hook)()) { buttonHook = hook; }
+
+void powerSoilWake(bool enabled) {
+  soilWatch = Hw::hasSoilComparator && enabled;
+}
+
+bool powerWokeBySoil() {
+  if (!soilWake) {
+    return false;
+  }
+  soilWake = false;
+  return true;
+}
+
+bool powerWokeByButton() {
+  if (!buttonWake) {
+    return false;
+  }
+  buttonWake = false;
+  return true;
+}
+
+void powerReport(Print &out) {
+#ifdef POWER_BENCHMARK
+  unsigned long total = millis();
+  unsigned long slept = min(sleptMillis, total);
+  float asleep = total ? (float)slept / total : 0.0f;
+  float averageUa =
+      Hw::activeCurrentUa - asleep * (Hw::activeCurrentUa - Hw::sleepCurrentUa);
+
+  out.print(F("PWR up="));
+  out.print(total / 1000UL);
+  out.print(F("s asleep="));
+  out.print(asleep * 100.0f, 1);
+  out.print(F("% sleeps="));
+  out.print(sleepCount);
+  out.print(F(" btn="));
+  out.print(buttonWakeCount);
+  out.print(F(" wake_us="));
+  out.print(buttonWakeCount ? wakeLatencyTotal / buttonWakeCount : 0UL);
+  out.print('/');
+  out.print(wakeLatencyMax);
+  out.print('+');
+  out.print(Hw::wakeStartupMicros);
+  out.print(F(" Iavg_uA="));
+  out.println((unsigned long)averageUa);
+#else
+  (void)out;
+#endif
+}
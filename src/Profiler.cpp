@@ -0,0 +1,89 @@
+/**
+ * @file Profiler.cpp
+ * @brief Log2 latency histograms per named section
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Bucket 0 counts runs under 256 µs; bucket k counts runs in
+ * [2^(k+7), 2^(k+8)) µs; the last bucket also takes everything longer
+ * (>= 262 ms). Counts are bytes: when one would overflow, the whole section
+ * is halved, which keeps the shape of the distribution.
+ */
+
+#include "Profiler.h"
+#include "MemoryMonitor.h"
+
+#ifdef PROFILING
+
+namespace {
+
+const uint8_t bucketCount = 12;
+
+struct SectionStats {
+  uint8_t buckets[bucketCount];
+  unsigned long longest; ///< Max blocking time of the section (µs)
+};
+
+SectionStats sections[PROFILE_SECTIONS];
+
+const char sectionNames[PROFILE_SECTIONS][6] PROGMEM = {"LOOP", "MENU",
+                                                        "WATER", "PROBE"};
+
+uint8_t bucketFor(unsigned long micros) {
+  uint8_t bucket = 0;
+  micros >>= 8;
+  while (micros != 0 && bucket < bucketCount - 1) {
+    micros >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+} // namespace
+
+void profileRecord(ProfileSection section, unsigned long micros) {
+  SectionStats &stats = sections[section];
+  uint8_t bucket = bucketFor(micros);
+
+  if (stats.buckets[bucket] == 0xFF) {
+    for (uint8_t i = 0; i < bucketCount; ++i) {
+      stats.buckets[i] >>= 1;
+    }
+  }
+  ++stats.buckets[bucket];
+
+  if (micros > stats.longest) {
+    stats.longest = micros;
+  }
+}
+
+void profileDump(Print &out) {
+  unsigned long blocking = 0;
+  for (uint8_t s = 0; s < PROFILE_SECTIONS; ++s) {
+    blocking = max(blocking, sections[s].longest);
+  }
+  out.print(F("PROF blk_us="));
+  out.println(blocking);
+
+  for (uint8_t s = 0; s < PROFILE_SECTIONS; ++s) {
+    char name[sizeof(sectionNames[0])];
+    strcpy_P(name, sectionNames[s]);
+    out.print(name);
+    out.print(F(" max_us="));
+    out.print(sections[s].longest);
+    out.print(F(" h="));
+    for (uint8_t i = 0; i < bucketCount; ++i) {
+      if (i != 0) {
+        out.print(',');
+      }
+      out.print(sections[s].buckets[i]);
+    }
+    out.println();
+  }
+
+  memoryReport(out);
+}
+
+void profileReset() { memset(sections, 0, sizeof(sections)); }
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * @file PumpCurve.cpp
+ * @brief Piecewise-linear calibration tables and dose planner
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Interpolation is done in float: products of run time and volume
+ * overflow 32 bits, and planning runs once per watering.
+ */
+
+#include "PumpCurve.h"
+#include "HardwareProfile.h"
+
+namespace {
+
+PumpCurvePoint curves[2][pumpCurveMaxPoints];
+uint8_t sizes[2] = {0, 0};
+
+/**
+ * @brief y at x on the line through two points (extends past either end)
+ */
+float interpolate(float x, float x0, float y0, float x1, float y1) {
+  if (x1 == x0) {
+    return y1;
+  }
+  return y0 + (x - x0) * (y1 - y0) / (x1 - x0);
+}
+
+/**
+ * @brief Flow (ml/min) at a PWM duty, clamped to the calibrated range
+ */
+float flowAtPwm(uint8_t pwm) {
+  const PumpCurvePoint *points = curves[PUMP_CURVE_FLOW];
+  uint8_t size = sizes[PUMP_CURVE_FLOW];
+  if (pwm <= points[0].x) {
+    return points[0].y;
+  }
+  for (uint8_t i = 1; i < size; ++i) {
+    if (pwm <= points[i].x) {
+      return interpolate(pwm, points[i - 1].x, points[i - 1].y, points[i].x,
+                         points[i].y);
+    }
+  }
+  return points[size - 1].y;
+}
+
+/**
+ * @brief Lowest PWM delivering at least a flow, clamped to the calibrated range
+ */
+uint8_t pwmForFlow(float flow) {
+  const PumpCurvePoint *points = curves[PUMP_CURVE_FLOW];
+  uint8_t size = sizes[PUMP_CURVE_FLOW];
+  if (flow <= points[0].y) {
+    return points[0].x;
+  }
+  for (uint8_t i = 1; i < size; ++i) {
+    if (flow <= points[i].y) {
+      float pwm = interpolate(flow, points[i - 1].y, points[i - 1].x,
+                              points[i].y, points[i].x);
+      return min(255.0f, pwm + 0.5f);
+    }
+  }
+  return points[size - 1].x;
+}
+
+} // namespace
+
+void pumpCurveClear(PumpCurveKind kind) { sizes[kind] = 0; }
+
+bool pumpCurveAdd(PumpCurveKind kind, uint32_t x, uint16_t y) {
+  if (x == 0 || y == 0 || (kind == PUMP_CURVE_FLOW && x > 255)) {
+    return false;
+  }
+  PumpCurvePoint *points = curves[kind];
+  uint8_t &size = sizes[kind];
+
+  // Same x, or the nearest one when full, is replaced
+  uint8_t slot = size;
+  uint32_t nearest = 0xFFFFFFFFUL;
+  for (uint8_t i = 0; i < size; ++i) {
+    uint32_t distance = points[i].x > x ? points[i].x - x : x - points[i].x;
+    if (distance == 0 || (size == pumpCurveMaxPoints && distance < nearest)) {
+      slot = i;
+      nearest = distance;
+    }
+  }
+
+  // y must rise with x on both curves; the lookups invert them
+  for (uint8_t i = 0; i < size; ++i) {
+    if (i != slot &&
+        (points[i].y == y || (points[i].x < x) != (points[i].y < y))) {
+      return false;
+    }
+  }
+  if (slot == size) {
+    ++size;
+  }
+  points[slot].x = x;
+  points[slot].y = y;
+
+  // Insertion sort; at most one point is out of place
+  for (uint8_t i = 1; i < size; ++i) {
+    for (uint8_t j = i; j > 0 && points[j - 1].x > points[j].x; --j) {
+      PumpCurvePoint swap = points[j];
+      points[j] = points[j - 1];
+      points[j - 1] = swap;
+    }
+  }
+  return true;
+}
+
+uint8_t pumpCurveSize(PumpCurveKind kind) { return sizes[kind]; }
+
+PumpCurvePoint pumpCurvePoint(PumpCurveKind kind, uint8_t index) {
+  return curves[kind][index];
+}
+
+unsigned long pumpCurveDuration(uint16_t volumeMl) {
+  const PumpCurvePoint *points = curves[PUMP_CURVE_TIME];
+  uint8_t size = sizes[PUMP_CURVE_TIME];
+  if (size == 0) {
+    return 0;
+  }
+
+  // Segments start at the implied origin; past the end the last one extends
+  float x0 = 0;
+  float y0 = 0;
+  for (uint8_t i = 0; i < size; ++i) {
+    if (volumeMl <= points[i].y || i == size - 1) {
+      float duration = interpolate(volumeMl, y0, x0, points[i].y, points[i].x);
+      return duration > 0 ? duration + 0.5f : 0;
+    }
+    x0 = points[i].x;
+    y0 = points[i].y;
+  }
+  return 0;
+}
+
+uint16_t pumpCurveVolume(uint8_t pwm, unsigned long durationMs) {
+  const PumpCurvePoint *points = curves[PUMP_CURVE_TIME];
+  uint8_t size = sizes[PUMP_CURVE_TIME];
+
+  if (pwm == Hw::pumpHighSetting && size > 0) {
+    float x0 = 0;
+    float y0 = 0;
+    for (uint8_t i = 0; i < size; ++i) {
+      if (durationMs <= points[i].x || i == size - 1) {
+        float volume =
+            interpolate(durationMs, x0, y0, points[i].x, points[i].y);
+        return volume > 0 ? volume + 0.5f : 0;
+      }
+      x0 = points[i].x;
+      y0 = points[i].y;
+    }
+  }
+  if (sizes[PUMP_CURVE_FLOW] > 0) {
+    return flowAtPwm(pwm) * durationMs / 60000.0f + 0.5f;
+  }
+  return 0;
+}
+
+bool pumpCurvePlan(uint16_t volumeMl, PumpPlan &plan) {
+  uint8_t flowPoints = sizes[PUMP_CURVE_FLOW];
+
+  if (volumeMl < Hw::pumpSmallDoseMl && flowPoints > 0 &&
+      curves[PUMP_CURVE_FLOW][0].x < Hw::pumpHighSetting) {
+    uint8_t pwm = pwmForFlow(volumeMl * 60000.0f / Hw::pumpMinDoseMs);
+    float flow = flowAtPwm(pwm);
+    plan.pwm = pwm;
+    plan.durationMs = volumeMl * 60000.0f / flow + 0.5f;
+    return true;
+  }
+
+  unsigned long duration = pumpCurveDuration(volumeMl);
+  if (duration == 0 && flowPoints > 0 &&
+      curves[PUMP_CURVE_FLOW][flowPoints - 1].x == Hw::pumpHighSetting) {
+    duration = volumeMl * 60000.0f / curves[PUMP_CURVE_FLOW][flowPoints - 1].y;
+  }
+  if (duration == 0) {
+    return false;
+  }
+  plan.pwm = Hw::pumpHighSetting;
+  plan.durationMs = duration;
+  return true;
+}
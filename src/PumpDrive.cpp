@@ -0,0 +1,202 @@
+/**
+ * @file PumpDrive.cpp
+ * @brief Soft-start ramp on the Timer1 overflow, and the pump heat model
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details The pump pin is a Timer1 output, so the overflow interrupt comes
+ * once per PWM period (~2 ms with the Arduino core's prescaler of 64) and is
+ * only enabled while a ramp runs. Heat is integrated in whole seconds from
+ * pumpDriveService(); starts are counted in the interrupt and charged on the
+ * next update.
+ */
+
+#include "PumpDrive.h"
+
+#include "HardwareProfile.h"
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#define PUMP_ATOMIC ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+
+static_assert(Hw::pump == 9 || Hw::pump == 10,
+              "Pump ramp expects a Timer1 PWM pin (OC1A/OC1B)");
+#else
+#define PUMP_ATOMIC
+#endif
+
+namespace {
+
+const uint8_t rampPoints = sizeof(pumpRampCurve) / sizeof(pumpRampCurve[0]);
+const unsigned long heatStepMs = 1000;
+const unsigned long tauMs = Hw::pumpThermalTauS * 1000UL;
+
+volatile uint8_t target = 0;   ///< Duty asked for
+volatile uint8_t output = 0;   ///< Duty on the pin
+volatile bool ramping = false;
+volatile unsigned long rampStart = 0;
+volatile uint8_t starts = 0;   ///< Starts not yet charged to heat
+
+unsigned long heat = 0;        ///< ms at full duty, less cooling
+unsigned long heatAt = 0;      ///< millis() heat is integrated up to
+
+void timerInterrupt(bool on) {
+#if defined(__AVR__)
+  if (on) {
+    TIFR1 = _BV(TOV1);
+    TIMSK1 |= _BV(TOIE1);
+  } else {
+    TIMSK1 &= ~_BV(TOIE1);
+  }
+#else
+  (void)on;
+#endif
+}
+
+void write(uint8_t duty) {
+  if (duty != output) {
+    analogWrite(Hw::pump, duty);
+    output = duty;
+  }
+}
+
+/**
+ * @brief Moves the ramp to the current time; interrupts off
+ */
+void step() {
+  if (!ramping) {
+    return;
+  }
+  unsigned long t = millis() - rampStart;
+  uint8_t i = 1;
+  while (i < rampPoints && t >= pumpRampCurve[i].atMs) {
+    ++i;
+  }
+  if (i == rampPoints) {
+    ramping = false;
+    timerInterrupt(false);
+    write(target);
+    return;
+  }
+  const PumpRampPoint &from = pumpRampCurve[i - 1];
+  const PumpRampPoint &to = pumpRampCurve[i];
+  uint16_t percent = from.percent + (to.percent - from.percent) *
+                                        (t - from.atMs) / (to.atMs - from.atMs);
+  uint8_t duty = static_cast<uint16_t>(target) * percent / 100;
+  write(duty > 0 ? duty : 1);
+}
+
+/**
+ * @brief Brings heat up to now
+ */
+void integrate() {
+  uint8_t newStarts;
+  PUMP_ATOMIC {
+    newStarts = starts;
+    starts = 0;
+  }
+  heat += newStarts * static_cast<unsigned long>(Hw::pumpStartHeatMs);
+
+  unsigned long now = millis();
+  if (heat == 0 && output == 0) {
+    heatAt = now;
+    return;
+  }
+  while (now - heatAt >= heatStepMs) {
+    heat += output * heatStepMs / 255;
+    heat -= (heat * heatStepMs + tauMs - 1) / tauMs;
+    heatAt += heatStepMs;
+  }
+}
+
+/**
+ * @brief Heat a run of runMs at pwm adds, start included if the pump is off
+ */
+unsigned long runHeat(unsigned long runMs, uint8_t pwm) {
+  unsigned long added = runMs / 255 * pwm + runMs % 255 * pwm / 255;
+  if (output == 0) {
+    added += Hw::pumpStartHeatMs;
+  }
+  return added;
+}
+
+} // namespace
+
+#if defined(__AVR__)
+ISR(TIMER1_OVF_vect) { step(); }
+#endif
+
+void pumpDriveBegin() {
+  PUMP_ATOMIC {
+    ramping = false;
+    timerInterrupt(false);
+    target = 0;
+    output = 0;
+    analogWrite(Hw::pump, 0);
+  }
+  heatAt = millis();
+}
+
+void pumpDriveSet(uint8_t pwm) {
+  PUMP_ATOMIC {
+    target = pwm;
+    if (pwm == 0 || output != 0) {
+      ramping = false;
+      timerInterrupt(false);
+      write(pwm);
+    } else if (!ramping) {
+      ramping = true;
+      rampStart = millis();
+      ++starts;
+      step();
+      timerInterrupt(true);
+    }
+  }
+}
+
+void pumpDriveStop() { pumpDriveSet(0); }
+
+uint8_t pumpDriveDuty() { return output; }
+
+void pumpDriveService() {
+#if !defined(__AVR__)
+  step(); // no Timer1 on the host
+#endif
+  integrate();
+}
+
+unsigned long pumpHeatHeadroomMs(uint8_t pwm) {
+  integrate();
+  if (pwm == 0) {
+    return 0xFFFFFFFFUL;
+  }
+  unsigned long used = heat;
+  if (output == 0) {
+    used += Hw::pumpStartHeatMs;
+  }
+  if (used >= Hw::pumpHeatBudgetMs) {
+    return 0;
+  }
+  unsigned long left = Hw::pumpHeatBudgetMs - used;
+  return left / pwm * 255 + left % pwm * 255 / pwm;
+}
+
+unsigned long pumpCoolDownMs(unsigned long runMs, uint8_t pwm) {
+  integrate();
+  const unsigned long minAllowed = Hw::pumpHeatBudgetMs / 4;
+  unsigned long needed = runHeat(runMs, pwm);
+  unsigned long allowed = needed < Hw::pumpHeatBudgetMs - minAllowed
+                              ? Hw::pumpHeatBudgetMs - needed
+                              : minAllowed;
+  if (heat <= allowed) {
+    return 0;
+  }
+  return tauMs * log(static_cast<float>(heat) / allowed);
+}
+
+uint8_t pumpHeatPercent() {
+  integrate();
+  unsigned long percent = heat / (Hw::pumpHeatBudgetMs / 100);
+  return percent < 255 ? percent : 255;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file Recorder.cpp
+ * @brief Packs input events into TELEMETRY_TRACE records
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details A record is only sent while the telemetry ring is empty, which
+ * leaves room for the largest record, so a send never fails and never burns a
+ * sequence number. Pin levels are kept as one bit per pin (pins 0-31).
+ */
+
+#include "Recorder.h"
+
+#ifdef RECORDING
+
+#include <stddef.h>
+
+#include "Telemetry.h"
+
+namespace {
+
+const unsigned int recordFlushMs = 250; ///< Oldest event before a flush
+
+TelemetryTrace record;
+uint8_t used = 0; ///< Bytes of record.events filled
+unsigned long lastEventMs = 0;
+uint32_t knownPins = 0; ///< Pins with a recorded level
+uint32_t pinLevels = 0; ///< Last recorded level of each known pin
+bool hasRtcOffset = false;
+int32_t rtcOffset = 0; ///< Last recorded RTC seconds minus millis() / 1000
+uint16_t lostEvents = 0;
+
+bool flush() {
+  if (used == 0) {
+    return true;
+  }
+  if (telemetryPending()) {
+    return false;
+  }
+  telemetryHeader(record.header, TELEMETRY_TRACE);
+  record.lost = lostEvents;
+  telemetrySend(&record, offsetof(TelemetryTrace, events) + used);
+  used = 0;
+  return true;
+}
+
+uint8_t varintSize(unsigned long value) {
+  uint8_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+/**
+ * @brief Appends one event, flushing first if it does not fit
+ * @return false if the event was dropped
+ */
+bool append(uint8_t tag, const void *payload, uint8_t size) {
+  unsigned long now = millis();
+  unsigned long delta = used != 0 ? now - lastEventMs : 0;
+  if (used + 1u + varintSize(delta) + size > sizeof(record.events)) {
+    if (!flush()) {
+      ++lostEvents;
+      return false;
+    }
+    delta = 0;
+  }
+  if (used == 0) {
+    record.startMs = now;
+  }
+  lastEventMs = now;
+
+  record.events[used++] = tag;
+  while (delta >= 0x80) {
+    record.events[used++] = static_cast<uint8_t>(delta) | 0x80;
+    delta >>= 7;
+  }
+  record.events[used++] = static_cast<uint8_t>(delta);
+  if (size != 0) {
+    memcpy(record.events + used, payload, size); // little-endian, as on host
+    used += size;
+  }
+  return true;
+}
+
+uint8_t tag(TraceKind kind, bool flag, uint8_t pin) {
+  return kind << 6 | (flag ? 0x20 : 0) | (pin & 0x1F);
+}
+
+} // namespace
+
+void recordPin(uint8_t pin, bool level) {
+  uint32_t bit = 1UL << (pin & 0x1F);
+  if ((knownPins & bit) && ((pinLevels & bit) != 0) == level) {
+    return;
+  }
+  if (append(tag(TRACE_PIN, level, pin), nullptr, 0)) {
+    knownPins |= bit;
+    pinLevels = level ? pinLevels | bit : pinLevels & ~bit;
+  }
+}
+
+void recordAnalog(uint8_t pin, uint16_t value) {
+  append(tag(TRACE_ANALOG, false, pin), &value, sizeof(value));
+}
+
+void recordRtc(uint32_t seconds) {
+  int32_t offset = static_cast<int32_t>(seconds - millis() / 1000UL);
+  // millis() and the RTC tick out of phase, so the offset jitters by one
+  if (hasRtcOffset && offset - rtcOffset <= 1 && rtcOffset - offset <= 1) {
+    return;
+  }
+  if (append(tag(TRACE_RTC, false, 0), &offset, sizeof(offset))) {
+    hasRtcOffset = true;
+    rtcOffset = offset;
+  }
+}
+
+void recordSerial(uint8_t data) {
+  append(tag(TRACE_SERIAL, false, 0), &data, sizeof(data));
+}
+
+void recordService() {
+  if (used != 0 && millis() - record.startMs >= recordFlushMs) {
+    flush();
+  }
+}
+
+uint16_t recordLost() { return lostEvents; }
+
+#endif
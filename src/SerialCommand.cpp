@@ -0,0 +1,142 @@
+/**
+ * @file SerialCommand.cpp
+ * @brief Byte-at-a-time command line state machine
+ * @author Quiyet Brul
+ * @date 2025
+ */
+
+#include "SerialCommand.h"
+#include "Recorder.h"
+
+namespace {
+
+/**
+ * @brief Parser position within the current line
+ */
+enum ParseState : uint8_t {
+  PARSE_VERB,   ///< Waiting for the verb letter
+  PARSE_GAP,    ///< Between tokens
+  PARSE_KEY,    ///< Inside the key token
+  PARSE_NUMBER, ///< Inside a numeric argument
+  PARSE_SKIP,   ///< Discarding a malformed line
+};
+
+ParseState state = PARSE_VERB;
+SerialCommand pending; ///< Line being decoded
+uint8_t keyLength = 0;
+bool negative = false;
+
+void resetLine() {
+  state = PARSE_VERB;
+  pending.verb = 0;
+  pending.key = 0;
+  pending.argc = 0;
+  pending.error = false;
+  keyLength = 0;
+}
+
+void finishNumber() {
+  if (negative) {
+    pending.argv[pending.argc] = -pending.argv[pending.argc];
+  }
+  ++pending.argc;
+}
+
+bool isLetter(char c) { return c >= 'a' && c <= 'z'; }
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+/**
+ * @brief Folds one byte into the pending line
+ * @return true when the byte ended a non-empty line
+ */
+bool feed(char c) {
+  if (c == '\r') {
+    return false;
+  }
+  if (c == '\n') {
+    if (state == PARSE_NUMBER) {
+      finishNumber();
+    }
+    return pending.verb != 0 || pending.error;
+  }
+  if (state == PARSE_SKIP) {
+    return false;
+  }
+
+  bool ok = true;
+  switch (state) {
+  case PARSE_VERB:
+    if (c == ' ') {
+      break;
+    }
+    ok = isLetter(c) || c == '?';
+    pending.verb = c;
+    state = PARSE_GAP;
+    break;
+  case PARSE_GAP:
+    if (c == ' ') {
+      break;
+    }
+    if (isLetter(c) && pending.key == 0 && pending.argc == 0) {
+      pending.key = commandKey(c, 0);
+      keyLength = 1;
+      state = PARSE_KEY;
+    } else if ((isDigit(c) || c == '-') && pending.argc < commandMaxArgs) {
+      negative = c == '-';
+      pending.argv[pending.argc] = negative ? 0 : c - '0';
+      state = PARSE_NUMBER;
+    } else {
+      ok = false;
+    }
+    break;
+  case PARSE_KEY:
+    if (c == ' ') {
+      state = PARSE_GAP;
+    } else if (isLetter(c) && keyLength < 2) {
+      pending.key |= static_cast<uint8_t>(c);
+      ++keyLength;
+    } else {
+      ok = false;
+    }
+    break;
+  case PARSE_NUMBER:
+    if (c == ' ') {
+      finishNumber();
+      state = PARSE_GAP;
+    } else if (isDigit(c) && pending.argv[pending.argc] < 100000000L) {
+      pending.argv[pending.argc] = pending.argv[pending.argc] * 10 + (c - '0');
+    } else {
+      ok = false;
+    }
+    break;
+  case PARSE_SKIP:
+    break;
+  }
+
+  if (!ok) {
+    pending.error = true;
+    state = PARSE_SKIP;
+  }
+  return false;
+}
+
+} // namespace
+
+bool commandPoll(SerialCommand &command) {
+  while (Serial.available() > 0) {
+    uint8_t data = Serial.read();
+    RECORD_SERIAL(data);
+    if (feed(static_cast<char>(data))) {
+      command = pending;
+      resetLine();
+      return true;
+    }
+  }
+  return false;
+}
+
+void commandEndReply() {
+  Serial.println();
+  Serial.write(static_cast<uint8_t>(0));
+}
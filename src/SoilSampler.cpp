@@ -0,0 +1,165 @@
+/**
+ * @file SoilSampler.cpp
+ * @brief Adaptive cadence for the soil probe
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details A change is measured against the previous sample, not a running
+ * average, so a slow drift (drying over hours) keeps backing off while a step
+ * (watering, a spill, the probe being moved) resets the cadence at once.
+ */
+
+#include "SoilSampler.h"
+
+#include "HardwareProfile.h"
+#include "Pin.h"
+#include "Recorder.h"
+
+namespace {
+
+typedef Pin<Hw::soilPower> SoilPower;
+
+const unsigned long fastPeriodMs = 2000UL;     ///< While and after watering
+const unsigned long settleMs = 600000UL;       ///< "After" lasts this long
+const unsigned long stablePeriodMs = 5000UL;   ///< First back-off step
+const unsigned long maxPeriodMs = 900000UL;    ///< Back-off ceiling
+const uint8_t watchShare = 4;                  ///< Watch <= period / this
+
+uint16_t lastRaw = 0;
+unsigned long takenAt = 0;        ///< millis() of lastRaw
+unsigned long period = stablePeriodMs;
+bool pumpRunning = false;
+unsigned long pumpStoppedAt = 0;
+bool settling = false;            ///< Within settleMs of a pump stop
+bool powered = false;             ///< Background read warming up
+unsigned long poweredAt = 0;
+
+bool fastCadence() {
+  if (settling && millis() - pumpStoppedAt >= settleMs) {
+    settling = false;
+  }
+  return pumpRunning || settling;
+}
+
+/**
+ * @brief How long after a sample the comparator may keep the probe powered
+ */
+unsigned long watchWindow() {
+  unsigned long window = period / watchShare;
+  return window < soilWatchMaxMs ? window : soilWatchMaxMs;
+}
+
+/**
+ * @brief Whether the comparator watches for drying (probe may be warming)
+ */
+bool watched() {
+  return Hw::hasSoilComparator && !fastCadence() &&
+         lastRaw >= Hw::soilWakeRaw && millis() - takenAt < watchWindow();
+}
+
+unsigned long currentPeriod() {
+  return fastCadence() ? fastPeriodMs : period;
+}
+
+/**
+ * @brief Stores a reading and adapts the back-off to it
+ */
+void store(uint16_t raw) {
+  unsigned int change = raw > lastRaw ? raw - lastRaw : lastRaw - raw;
+  if (change >= soilChangeCounts) {
+    period = stablePeriodMs;
+  } else if (period < maxPeriodMs) {
+    period = period * 2 < maxPeriodMs ? period * 2 : maxPeriodMs;
+  }
+  lastRaw = raw;
+  takenAt = millis();
+}
+
+void powerOff() {
+  SoilPower::low();
+  powered = false;
+}
+
+uint16_t readProbe() {
+  uint16_t raw = analogRead(Hw::soilRead);
+  RECORD_ANALOG(Hw::soilRead, raw);
+  powerOff();
+  return raw;
+}
+
+} // namespace
+
+void soilBegin() {
+  SoilPower::output();
+  pinMode(Hw::soilRead, INPUT_PULLUP);
+  soilRead(0);
+}
+
+void soilService() {
+  unsigned long now = millis();
+  if (powered) {
+    if (now - poweredAt < soilWarmMs || watched()) {
+      return;
+    }
+    if (now - takenAt >= currentPeriod()) {
+      store(readProbe());
+    } else {
+      powerOff(); // watch window over: back to timed samples
+    }
+    return;
+  }
+  if (watched() || now - takenAt >= currentPeriod()) {
+    SoilPower::high();
+    powered = true;
+    poweredAt = now;
+  }
+}
+
+SoilSample soilLatest() {
+  SoilSample sample;
+  sample.raw = lastRaw;
+  sample.ageMs = millis() - takenAt;
+  return sample;
+}
+
+SoilSample soilRead(unsigned long maxAgeMs) {
+  if (maxAgeMs == 0 || millis() - takenAt > maxAgeMs) {
+    if (!powered) {
+      SoilPower::high();
+      poweredAt = millis();
+    }
+    unsigned long warm = millis() - poweredAt;
+    if (warm < soilWarmMs) {
+      delay(soilWarmMs - warm);
+    }
+    store(readProbe());
+  }
+  return soilLatest();
+}
+
+void soilWatering(bool running) {
+  if (pumpRunning && !running) {
+    pumpStoppedAt = millis();
+    settling = true;
+  }
+  pumpRunning = running;
+}
+
+unsigned long soilDueIn() {
+  unsigned long now = millis();
+  unsigned long due = currentPeriod();
+  unsigned long elapsed = now - takenAt;
+  unsigned long left = elapsed < due ? due - elapsed : 0;
+  if (powered) {
+    unsigned long warm = now - poweredAt;
+    if (warm < soilWarmMs) {
+      return soilWarmMs - warm;
+    }
+    return watched() ? watchWindow() - elapsed : 0;
+  }
+  return watched() ? 0 : left;
+}
+
+bool soilWatching() {
+  return powered && millis() - poweredAt >= soilWarmMs && watched();
+}
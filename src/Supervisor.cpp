@@ -0,0 +1,203 @@
+/**
+ * @file Supervisor.cpp
+ * @brief Watchdog ownership, fault record and safety checks
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details The fault record lives in .noinit so a watchdog reset does not
+ * clear it; a check byte tells a surviving record from power-on garbage.
+ * The host build has no watchdog: feeding is a no-op and
+ * supervisorWatchdogExpired() only does the safe-output and record part.
+ */
+
+#include "Supervisor.h"
+#include "HardwareProfile.h"
+#include "Pin.h"
+#include "PumpDrive.h"
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#include <avr/wdt.h>
+#endif
+
+namespace {
+
+const uint16_t faultMagic = 0x5AFE;
+
+/**
+ * @brief Fault history kept across watchdog resets
+ */
+struct FaultRecord {
+  uint16_t magic;
+  uint8_t last;  ///< SupervisorFault
+  uint8_t count; ///< Faults since power-on
+  uint8_t check; ///< ~(last ^ count)
+};
+
+#if defined(__AVR__)
+FaultRecord record __attribute__((section(".noinit")));
+#else
+FaultRecord record;
+#endif
+
+bool armed = false;
+bool pumpOn = false;
+unsigned long pumpOnSince = 0;
+uint16_t screenSeconds = 0;
+unsigned long lastActivity = 0;
+bool exitRequested = false;
+
+bool isRecordValid() {
+  return record.magic == faultMagic &&
+         record.check == (uint8_t)~(record.last ^ record.count);
+}
+
+void writeRecord(uint8_t fault) {
+  record.magic = faultMagic;
+  record.last = fault;
+  if (record.count < 0xFF) {
+    ++record.count;
+  }
+  record.check = ~(record.last ^ record.count);
+}
+
+/**
+ * @brief Pump PWM to zero and valve closed, whatever the caller believes
+ */
+void safeOutputs() {
+  pumpDriveStop();
+  if (Hw::hasValve) {
+    Pin<Hw::pumpValve>::low();
+  }
+}
+
+#if defined(__AVR__)
+/**
+ * @brief Interrupt-then-reset mode, ~8 s; must be called with interrupts off
+ */
+void watchdogArm() {
+  wdt_reset();
+  MCUSR &= ~_BV(WDRF);
+  WDTCSR = _BV(WDCE) | _BV(WDE);
+  WDTCSR = _BV(WDIE) | _BV(WDE) | _BV(WDP3) | _BV(WDP0);
+}
+#endif
+
+} // namespace
+
+#if defined(__AVR__)
+/**
+ * @brief Stops a watchdog left running by a watchdog reset
+ * @details Runs from .init3. Without a bootloader to clear it, the watchdog
+ * stays enabled at its shortest period after a reset and would fire again
+ * long before setup() reaches supervisorBegin().
+ */
+extern "C" void supervisorEarlyInit() __attribute__((naked, used, section(".init3")));
+
+void supervisorEarlyInit() {
+  MCUSR = 0;
+  wdt_disable();
+}
+#endif
+
+SupervisorFault supervisorBegin() {
+  SupervisorFault resetBy = FAULT_NONE;
+  if (!isRecordValid()) {
+    record.count = 0;
+  } else if (record.last == FAULT_WATCHDOG) {
+    resetBy = FAULT_WATCHDOG;
+  }
+  // Reported once; a later reset by the button must not repeat it
+  record.magic = faultMagic;
+  record.last = FAULT_NONE;
+  record.check = ~(record.last ^ record.count);
+
+  armed = true;
+#if defined(__AVR__)
+  cli();
+  watchdogArm();
+  sei();
+#endif
+  return resetBy;
+}
+
+SupervisorFault supervisorPoll(bool pumpRunning, bool hasWater) {
+  SupervisorFault fault = FAULT_NONE;
+  unsigned long now = millis();
+
+  if (pumpRunning && now - pumpOnSince >= Hw::pumpMaxRuntimeMs) {
+    fault = FAULT_PUMP_RUNTIME;
+  } else if (pumpRunning && Hw::hasFloatSwitch && !hasWater) {
+    fault = FAULT_PUMP_DRY;
+  } else if (!pumpRunning && screenSeconds != 0 &&
+             now - lastActivity >= screenSeconds * 1000UL) {
+    // A timed pump run is bounded by the runtime cap instead
+    exitRequested = true;
+  }
+  if (fault != FAULT_NONE) {
+    supervisorFault(fault);
+  }
+
+#if defined(__AVR__)
+  wdt_reset();
+#endif
+  return fault;
+}
+
+void supervisorPumpChanged(bool on) {
+  if (on && !pumpOn) {
+    pumpOnSince = millis();
+  }
+  pumpOn = on;
+  lastActivity = millis();
+}
+
+void supervisorScreen(uint16_t seconds) {
+  screenSeconds = seconds;
+  lastActivity = millis();
+}
+
+void supervisorLeaveScreen() {
+  screenSeconds = 0;
+  exitRequested = false;
+}
+
+void supervisorActivity() { lastActivity = millis(); }
+
+bool supervisorExitRequested() { return exitRequested; }
+
+void supervisorFault(SupervisorFault fault) {
+  safeOutputs();
+  pumpOn = false;
+  writeRecord(fault);
+}
+
+SupervisorFault supervisorLastFault() {
+  return (SupervisorFault)record.last;
+}
+
+uint8_t supervisorFaultCount() { return record.count; }
+
+void supervisorWatchdogResume() {
+#if defined(__AVR__)
+  if (armed) {
+    watchdogArm();
+    return;
+  }
+  wdt_reset();
+  MCUSR &= ~_BV(WDRF);
+  WDTCSR = _BV(WDCE) | _BV(WDE);
+  WDTCSR = 0;
+#endif
+}
+
+void supervisorWatchdogExpired() {
+  supervisorFault(FAULT_WATCHDOG);
+#if defined(__AVR__)
+  // Reset now rather than one more period later
+  WDTCSR = _BV(WDCE) | _BV(WDE);
+  WDTCSR = _BV(WDE);
+  while (true) {
+  }
+#endif
+}
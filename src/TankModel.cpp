@@ -0,0 +1,81 @@
+/**
+ * @file TankModel.cpp
+ * @brief Dispensed-volume integration reconciled with the float switch
+ * @author Quiyet Brul
+ * @date 2025
+ */
+
+#include "TankModel.h"
+#include "HardwareProfile.h"
+
+namespace {
+
+uint16_t remainingMl = Hw::tankCapacityMl;
+bool settledHasWater = true; ///< Switch state the model acts on
+bool rawHasWater = true;     ///< Switch state as last read
+unsigned long rawSince = 0;  ///< millis() rawHasWater was first read
+
+/**
+ * @brief The level the switch proves right after it changes state
+ */
+uint16_t levelAtSwitch(bool hasWater) {
+  if (hasWater) {
+    return Hw::tankCapacityMl; // Rising edge: refilled
+  }
+  return Hw::tankLowMarkMl;
+}
+
+} // namespace
+
+void tankBegin(bool hasWater) {
+  remainingMl = levelAtSwitch(hasWater);
+  settledHasWater = hasWater;
+  rawHasWater = hasWater;
+  rawSince = millis();
+}
+
+void tankUpdate(bool hasWater) {
+  unsigned long now = millis();
+  if (hasWater != rawHasWater) {
+    rawHasWater = hasWater;
+    rawSince = now;
+  }
+  if (rawHasWater != settledHasWater && now - rawSince >= tankSettleMs) {
+    settledHasWater = rawHasWater;
+    remainingMl = levelAtSwitch(settledHasWater);
+    return;
+  }
+
+  // Level is known to be on one side of the switch mark
+  if (settledHasWater && remainingMl <= Hw::tankLowMarkMl) {
+    remainingMl = Hw::tankLowMarkMl + 1;
+  } else if (!settledHasWater && remainingMl > Hw::tankLowMarkMl) {
+    remainingMl = Hw::tankLowMarkMl;
+  }
+}
+
+bool tankHasWater() { return settledHasWater; }
+
+void tankDispensed(uint16_t volumeMl) {
+  remainingMl = volumeMl < remainingMl ? remainingMl - volumeMl : 0;
+}
+
+uint16_t tankRemainingMl() { return remainingMl; }
+
+void tankSetRemaining(uint16_t volumeMl) {
+  remainingMl = volumeMl;
+  if (remainingMl > Hw::tankCapacityMl) {
+    remainingMl = Hw::tankCapacityMl;
+  }
+}
+
+uint16_t tankHoursToLow(unsigned long dailyUseMl) {
+  if (dailyUseMl == 0) {
+    return tankNoPrediction;
+  }
+  if (remainingMl <= Hw::tankLowMarkMl) {
+    return 0;
+  }
+  unsigned long hours = (remainingMl - Hw::tankLowMarkMl) * 24UL / dailyUseMl;
+  return min(hours, (unsigned long)tankNoPrediction - 1);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file Telemetry.cpp
+ * @brief COBS framing and non-blocking TX ring for telemetry records
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Frames are COBS-encoded straight into the ring: a slot is reserved
+ * for each block's code byte and filled in once the block ends. Records are at
+ * most 32 bytes, so a block never reaches the 254-byte COBS limit and a frame
+ * is at most size + 4 bytes (CRC, first code byte, 0x00 delimiter). The CRC is
+ * appended high byte first.
+ */
+
+#include "Telemetry.h"
+
+#if defined(__AVR__)
+#include <util/crc16.h>
+#endif
+
+namespace {
+
+const uint8_t ringSize = 64; ///< Power of two; counters wrap at 256
+const uint8_t ringMask = ringSize - 1;
+const uint8_t maxRecordSize = 32;
+
+uint8_t ring[ringSize];
+uint8_t ringHead = 0; ///< Free-running write counter
+uint8_t ringTail = 0; ///< Free-running read counter
+uint8_t sequence = 0;
+uint16_t droppedFrames = 0;
+
+uint8_t ringUsed() { return static_cast<uint8_t>(ringHead - ringTail); }
+
+} // namespace
+
+uint16_t telemetryCrc16(uint16_t crc, uint8_t data) {
+#if defined(__AVR__)
+  return _crc_xmodem_update(crc, data);
+#else
+  crc ^= static_cast<uint16_t>(data) << 8;
+  for (uint8_t i = 0; i < 8; ++i) {
+    crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+#endif
+}
+
+void telemetryHeader(TelemetryHeader &header, TelemetryType type) {
+  header.type = type;
+  header.seq = sequence++;
+  header.timeMs = millis();
+}
+
+bool telemetrySend(const void *record, uint8_t size) {
+  if (size > maxRecordSize || ringSize - ringUsed() < size + 4) {
+    ++droppedFrames;
+    return false;
+  }
+
+  const uint8_t *bytes = static_cast<const uint8_t *>(record);
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < size; ++i) {
+    crc = telemetryCrc16(crc, bytes[i]);
+  }
+
+  uint8_t codeSlot = ringHead++;
+  uint8_t code = 1;
+  for (uint8_t i = 0; i < size + 2; ++i) {
+    uint8_t b = i < size ? bytes[i] : (i == size ? crc >> 8 : crc & 0xFF);
+    if (b == 0) {
+      ring[codeSlot & ringMask] = code;
+      codeSlot = ringHead++;
+      code = 1;
+    } else {
+      ring[ringHead++ & ringMask] = b;
+      ++code;
+    }
+  }
+  ring[codeSlot & ringMask] = code;
+  ring[ringHead++ & ringMask] = 0;
+  return true;
+}
+
+void telemetryService() {
+  while (ringTail != ringHead && Serial.availableForWrite() > 0) {
+    Serial.write(ring[ringTail++ & ringMask]);
+  }
+}
+
+bool telemetryPending() { return ringTail != ringHead; }
+
+uint16_t telemetryDropped() { return droppedFrames; }
@@ -0,0 +1,101 @@
+/**
+ * @file WateringWindow.cpp
+ * @brief Deferral of due waterings to the allowed hours
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details One watering waits at most: this controller drives a single pump,
+ * so everything due while it waits is the same run.
+ */
+
+#include "WateringWindow.h"
+
+#include "HardwareProfile.h"
+
+namespace {
+
+uint32_t allowedHours = 0xFFFFFFUL; ///< Bit h: hour h allowed
+uint8_t batchMinutes = Hw::wateringBatchMin;
+bool pending = false;
+uint8_t pendingReason = 0;
+unsigned long dueAt = 0;    ///< millis() the waiting watering came due
+unsigned long waitMs = 0;   ///< How long it waits from dueAt
+bool ranOnce = false;
+unsigned long ranAt = 0;    ///< millis() of the last run
+
+bool hourAllowed(uint8_t hour) { return (allowedHours >> hour) & 1; }
+
+/**
+ * @brief Time from now to the start of the next allowed hour
+ * @details A full day when no hour is allowed; the lateness cap applies.
+ */
+unsigned long millisUntilOpen(const RtcDateTime &now) {
+  uint8_t hours = 1;
+  while (hours < 24 && !hourAllowed((now.Hour() + hours) % 24)) {
+    ++hours;
+  }
+  return (hours * 3600UL - now.Minute() * 60UL - now.Second()) * 1000UL;
+}
+
+} // namespace
+
+void windowSetHours(uint32_t hours) { allowedHours = hours & 0xFFFFFFUL; }
+
+uint32_t windowHours() { return allowedHours; }
+
+void windowSetBatchMinutes(uint8_t minutes) { batchMinutes = minutes; }
+
+uint8_t windowBatchMinutes() { return batchMinutes; }
+
+bool windowQueue(uint8_t reason, const RtcDateTime &now) {
+  if (ranOnce && millis() - ranAt < batchMinutes * 60000UL) {
+    return false;
+  }
+  if (pending) {
+    return true;
+  }
+  pending = true;
+  pendingReason = reason;
+  dueAt = millis();
+  waitMs = 0;
+  if (!hourAllowed(now.Hour())) {
+    const unsigned long maxLateMs = Hw::wateringMaxLateMin * 60000UL;
+    unsigned long untilOpen = millisUntilOpen(now);
+    waitMs = untilOpen < maxLateMs ? untilOpen : maxLateMs;
+  }
+  return true;
+}
+
+void windowRetry(uint8_t reason, unsigned long wait) {
+  pending = true;
+  pendingReason = reason;
+  dueAt = millis();
+  waitMs = wait;
+}
+
+bool windowPending() { return pending; }
+
+bool windowReady(uint8_t &reason) {
+  if (!pending || millis() - dueAt < waitMs) {
+    return false;
+  }
+  pending = false;
+  reason = pendingReason;
+  return true;
+}
+
+unsigned long windowDueIn() {
+  if (!pending) {
+    return 0;
+  }
+  unsigned long waited = millis() - dueAt;
+  return waited < waitMs ? waitMs - waited : 0;
+}
+
+void windowRan() {
+  pending = false;
+  ranOnce = true;
+  ranAt = millis();
+}
+
+void windowCancel() { pending = false; }
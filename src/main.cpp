@@ -17,29 +17,48 @@
  */
 
 #include <Arduino.h>
-#include <LiquidCrystal_I2C.h>
 #include <RtcDS1302.h>
 #include <Wire.h>
 
+#include "Animation.h"
+#include "Display.h"
+#include "EventLog.h"
+#include "FlowMeter.h"
+#include "HardwareProfile.h"
+#include "ManualPump.h"
+#include "MemoryMonitor.h"
+#include "Menu.h"
+#include "Pin.h"
+#include "PlantProfile.h"
+#include "Power.h"
+#include "Profiler.h"
+#include "PumpCurve.h"
+#include "PumpDrive.h"
+#include "Recorder.h"
+#include "SerialCommand.h"
+#include "SoilSampler.h"
+#include "Supervisor.h"
+#include "TankModel.h"
+#include "Telemetry.h"
+#include "WateringWindow.h"
+
 // ========================================
 // HARDWARE CONFIGURATION
 // ========================================
 
 /**
  * @brief LCD display object (16x2 characters, I2C interface)
- * @details Uses I2C address 0x27, common for most I2C LCD modules
+ * @details Address and geometry come from the hardware profile (Hw). Runs
+ * headless, optionally mirrored over Serial, when no LCD answers at boot.
  */
-LiquidCrystal_I2C lcd(0x27, 16, 2);
+Display lcd;
 
 /**
  * @name RTC (Real-Time Clock) Configuration
- * @brief DS1302 RTC module pin assignments and initialization
+ * @brief DS1302 RTC module initialization
  * @{
  */
-const byte CLK = 7; ///< Clock pin for DS1302 RTC
-const byte DAT = 6; ///< Data pin for DS1302 RTC
-const byte RST = 8; ///< Reset pin for DS1302 RTC
-ThreeWire rtcWire(DAT, CLK, RST);
+ThreeWire rtcWire(Hw::rtcDat, Hw::rtcClk, Hw::rtcRst);
 RtcDS1302<ThreeWire> rtc(rtcWire);
 /** @} */
 
@@ -48,46 +67,54 @@ RtcDS1302<ThreeWire> rtc(rtcWire);
  * @brief Navigation buttons for menu system
  * @{
  */
-const byte buttonPins[] = {2, 3, 4, 5}; ///< Button pins: [-, +, M, A]
+constexpr byte buttonPins[] = {Hw::buttonMinus, Hw::buttonPlus, Hw::buttonM,
+                               Hw::buttonA}; ///< Button pins: [-, +, M, A]
 const byte totalButtons = sizeof(buttonPins) / sizeof(buttonPins[0]);
 enum buttonNames { minus = 0, plus = 1, em = 2, aye = 3 };
 /** @} */
 
 /**
- * @name Sensor Pin Configuration
- * @brief Analog and digital pins for moisture and water sensors
+ * @name Sensor State
  * @{
  */
-const unsigned char pinSoilPower = 11; ///< Power pin for soil moisture sensor
-const unsigned char pinSoilRead = A2;  ///< Analog read pin for soil moisture
-const unsigned char waterDetectionRead =
-    A3; ///< Analog read pin for water detection
-const unsigned char waterDetectionPower =
-    13; ///< Power pin for water detection sensor
+unsigned int lastWaterDetectValue = 0;  ///< Last spill probe reading
+EventKind lastWaterBlock = EVENT_SKIP_TANK; ///< Why watering was last refused
+bool tankHadWater = true; ///< Settled float switch state last logged
 /** @} */
 
 /**
- * @name Sensor Thresholds and Calibration
- * @brief Calibration values and thresholds for sensor readings
+ * @name Pump State
+ * @brief Current pump run, reported over telemetry
  * @{
  */
-const unsigned char waterSensorPin = 12; ///< Digital pin for water level sensor
-const unsigned int DRY_VALUE = 300; ///< Raw ADC value for completely dry soil
-const unsigned int WET_VALUE = 880; ///< Raw ADC value for completely wet soil
-const unsigned int waterDetectThreshold =
-    350; ///< Threshold for water detection sensor
-unsigned long lastRawMoistureValue = 0; ///< Last raw moisture reading cache
+bool isPumpRunning = false;      ///< Pump currently on
+unsigned long pumpStartedAt = 0; ///< millis() when the current run started
+uint8_t pumpReason = PUMP_REASON_MANUAL; ///< Why the current run started
+uint32_t pumpStartPulses = 0;    ///< flowPulses() when the current run started
+uint8_t pumpPwm = 0;             ///< Duty of the current run
+
+/**
+ * @brief How a timed or metered pump run ended
+ */
+enum PumpRunResult {
+  PUMP_RUN_DONE,    ///< Target volume (or time, when unmetered) reached
+  PUMP_RUN_ABORTED, ///< Serial abort
+  PUMP_RUN_STALLED, ///< No flow pulses: pump dry or hose blocked
+  PUMP_RUN_TIMEOUT, ///< Metered run hit its time fallback before the volume
+  PUMP_RUN_FAULT,   ///< Supervisor cut the pump (runtime cap, tank low)
+  PUMP_RUN_HOT,     ///< Pump used up its heat budget (PumpDrive.h)
+};
 /** @} */
 
 /**
- * @name Pump and Valve Configuration
- * @brief Water pump control pins and timing parameters
+ * @name Pin Descriptors
+ * @brief Compile-time port bindings for the pins used in hot paths
  * @{
  */
-const unsigned char pumpValvePin = 9; ///< Digital pin controlling water valve
-const unsigned char pumpPin = 10;     ///< PWM pin controlling pump speed
-const unsigned int pumpValveTiming = 2000; ///< Valve operation delay (ms)
-const unsigned char pumpHighSetting = 255; ///< Full speed PWM value for pump
+typedef Pin<Hw::waterDetectPower> WaterDetectPower; ///< Water probe supply
+typedef Pin<Hw::floatSwitch> WaterLevelSwitch;      ///< Tank float switch
+typedef Pin<Hw::pumpValve> PumpValve;               ///< Valve relay
+typedef Pin<Hw::buttonM> ButtonM;                   ///< (M) button
 /** @} */
 
 /**
@@ -96,13 +123,17 @@ const unsigned char pumpHighSetting = 255; ///< Full speed PWM value for pump
  * @{
  */
 unsigned int waterInterval = 0;        ///< Time between waterings (minutes)
-unsigned int waterIntervalHour = 60;   ///< Default watering interval (minutes)
-unsigned int waterIntervalDelta = 60;  ///< Increment step for interval setting
+int16_t waterIntervalHour = 60; ///< Interval offered on the LCD (minutes)
 unsigned long waterDuration = 20000UL; ///< Duration of watering cycle (ms)
+unsigned int waterVolumeMl = 0;  ///< Metered dose (ml), 0 = timed dose only
 float moistureLevel = 0.0;             ///< Current soil moisture percentage
 unsigned long oneCupCalibrated = 0; ///< Calibrated time for 1 cup of water (ms)
 unsigned long autoWaterDurationMillis =
     0; ///< Calculated watering duration for auto mode
+unsigned int waterDetectThreshold =
+    Hw::waterDetectThreshold; ///< Spill probe reading that blocks watering
+PumpPlan heatRemainder = {0, 0}; ///< Rest of a dose split for pump heat
+unsigned int heatRemainderMl = 0; ///< Its volume (ml), 0 = timed
 /** @} */
 
 /**
@@ -120,7 +151,10 @@ const unsigned int bootWait = 3500;          ///< Initial boot wait time
 const unsigned int transitionDelay = 2000;   ///< Menu transition delay
 const unsigned int exitDelay = 1000;         ///< Exit message display time
 const unsigned char sensorWarmTime = 200;    ///< Sensor stabilization time
+const unsigned int manualProbeInterval = 250; ///< Spill re-read, manual mode
 const unsigned int blinkInterval = 500;      ///< Clock colon blink interval
+const unsigned int telemetryInterval = 10000; ///< Status record period
+const unsigned int millilitresPerCup = 237;   ///< US cup
 /** @} */
 
 /**
@@ -129,7 +163,6 @@ const unsigned int blinkInterval = 500;      ///< Clock colon blink interval
  * @{
  */
 unsigned long lastTimeButtonStateChanged = 0; ///< Last button state change time
-unsigned char debounceDuration = 100;         ///< Button debounce duration
 unsigned char lastButtonState;                ///< Previous button state
 /** @} */
 
@@ -146,6 +179,18 @@ unsigned long lastMessageSwitch = 0; ///< Last time main menu message switched
 static bool showColon = true;        ///< Clock colon visibility toggle
 unsigned long lastBlink = 0;         ///< Last colon blink time
 unsigned long autoTimer = 0;         ///< Timer for automatic watering intervals
+unsigned long lastUserActivity = 0;  ///< Last button press or menu exit
+bool isBacklightOn = true;           ///< LCD backlight state (dims when idle)
+unsigned long lastTelemetryStatus = 0; ///< Last status record sent
+bool wateringRequested = false; ///< Serial asked for a watering run
+bool onClockScreen = false; ///< showClock() runs (and with it auto mode)
+bool wateringAbortRequested = false; ///< Serial asked to stop the current run
+bool pumpStarting = false; ///< pumpStart() is waiting for the valve
+#ifdef FAULT_INJECTION
+bool injectedDryTank = false; ///< `f 3`: supervisor sees the tank as low
+#else
+const bool injectedDryTank = false;
+#endif
 /** @} */
 
 /**
@@ -167,6 +212,13 @@ const unsigned char totalMessages =
 void displayStartup();
 void loop();
 void setup();
+void idleUntilNextEvent();
+void clockIdle();
+void sleepWatchingSoil(unsigned long maxMs);
+void serviceTick();
+void serviceNap();
+void serviceDelay(unsigned long ms);
+void handleFault(SupervisorFault fault);
 
 // ========================================
 // MAIN MENU & NAVIGATION
@@ -175,6 +227,7 @@ void showMessageCycle();
 void checkButtons();
 void handleMenu(unsigned char menu);
 bool isButtonPressed(unsigned char pin);
+void waitForRelease(unsigned char pin);
 
 // ========================================
 // PRIMARY FEATURE
@@ -183,8 +236,10 @@ void showClock();
 void showMessageCycleClock();
 void manualWatering();
 void autoWatering();
-void waterPlant();
+void waterPlant(uint8_t reason);
+void deferHeatRemainder(uint8_t reason);
 void autoWateringCheck();
+PumpRunResult runPump(unsigned long durationMs, unsigned int volumeMl);
 
 // ========================================
 // SETTINGS & CONFIGURATION
@@ -193,6 +248,9 @@ void settingsMenu();
 void setDateTime();
 void waterCalibrationTest();
 void disableMessages();
+void showDiagnostics();
+void showEventLog();
+void choosePlantProfile();
 
 // ========================================
 // SENSOR & HARDWARE
@@ -201,25 +259,177 @@ float readSoilMoisture();
 unsigned char calculateMoisture(unsigned int raw);
 bool isWaterDetected();
 bool isPlantOkayToWater();
+void pumpStart(bool settleValve, uint8_t reason, uint8_t pwm);
+void pumpStarted(uint8_t reason, uint8_t pwm, unsigned long startedAt);
+void pumpStop(bool settleValve);
+void pumpStopped(unsigned long stoppedAt);
+unsigned long wateringIntervalMillis();
+bool hasDoseCalibration();
+void setDoseMillilitres(unsigned int volumeMl);
+unsigned int estimateVolumeMl(uint8_t pwm, unsigned long durationMs);
+unsigned long dailyWaterUseMl();
+unsigned long millisUntilWatering();
+void sendTelemetryStatus();
+
+// ========================================
+// REMOTE CONTROL
+// ========================================
+void handleSerialCommand(const SerialCommand &command);
+bool printSetting(uint16_t key);
+bool applySetting(const SerialCommand &command);
+void printEventLog();
+#ifdef FAULT_INJECTION
+bool injectFault(long fault);
+#endif
 
 // ========================================
 // DISPLAY & UI UTILITY
 // ========================================
 void printMessage(int x, int y, const String &message);
-void printAnimation(String message);
+void printAnimation(const char *message);
 void printExitCurrentMenu();
 void printInstructions();
+bool skipAnimationOnPress();
+void waitForAnimation();
+MenuKey readMenuKey(bool &held);
+MenuResult runMenu();
 void formatTime(int &hour, bool &isPM);
 
 // ========================================
 // STRING FORMATTING
 // ========================================
 String getMoistureValue();
+String getMainMenuBanner();
 String getNextFeed(unsigned long totalSecondsRemaining, unsigned long hoursPart,
                    unsigned long minutesPart);
 String getTime(const RtcDateTime &now);
 String getDate(const RtcDateTime &now);
 
+// ========================================
+// MENU TABLES
+// ========================================
+
+/**
+ * @name Menu Edit Values
+ * @brief Variables the menu forms edit, applied by the functions below
+ * @{
+ */
+int16_t dateTimeValues[5];       ///< Year, month, day, hour, minute being set
+int16_t doseTenthsOfCup = 10;    ///< Auto-mode dose (0.1 cup)
+int16_t calibrationSeconds = 30; ///< Calibration run time (s)
+int16_t calibrationSpeed = 100;  ///< Calibration pump speed (%)
+int16_t calibrationVolume = 0;   ///< Measured calibration output (ml)
+int16_t plantChoice = 0;         ///< Plant profile being picked
+MenuRange doseRange = {5, 100, 5}; ///< Cups (0.1) the profile allows
+MenuRange intervalRange = {60, plantMaxIntervalMin, 60}; ///< Minutes allowed
+/** @} */
+
+/**
+ * @brief Turns the cups chosen on the LCD into the auto-mode dose
+ */
+void applyDose() {
+  setDoseMillilitres(static_cast<long>(doseTenthsOfCup) * millilitresPerCup /
+                     10);
+  autoWaterDurationMillis = waterDuration;
+}
+
+/**
+ * @brief Schedules auto mode at the interval chosen on the LCD
+ */
+void applyWaterInterval() { waterInterval = waterIntervalHour; }
+
+/**
+ * @brief Makes plantChoice the active profile and fits the settings to it
+ * @details The LCD ranges follow the profile; a dose above its maximum or an
+ * interval below its spacing is brought within it.
+ */
+void applyPlantProfile() {
+  plantSelect(plantChoice);
+  uint16_t spacing = plant.minSpacingMin;
+  doseRange.maxValue = plant.maxDoseMl * 10UL / millilitresPerCup;
+  intervalRange.minValue = spacing;
+  intervalRange.maxValue = plantMaxIntervalMin / spacing * spacing;
+  intervalRange.step = spacing;
+
+  doseTenthsOfCup = min(doseTenthsOfCup, doseRange.maxValue);
+  if (waterVolumeMl > plant.maxDoseMl) {
+    setDoseMillilitres(plant.maxDoseMl);
+    autoWaterDurationMillis = waterDuration;
+  }
+  waterIntervalHour = (waterIntervalHour + spacing - 1) / spacing * spacing;
+  if (waterInterval != 0 && waterInterval < spacing) {
+    waterInterval = spacing;
+  }
+}
+
+/**
+ * @brief Profile name shown in place of plantChoice
+ */
+const char *plantChoiceName(int16_t value) { return plantName(value); }
+
+/**
+ * @name Menus
+ * @brief One item per setting; see Menu.h
+ * @{
+ */
+constexpr MenuItem settingsList[] PROGMEM = {
+    {MENU_ACTION, "1.Set Time/Date", "", 0, 0, 0, 0, nullptr, setDateTime,
+     nullptr, nullptr},
+    {MENU_ACTION, "2.Calibrate Test", "", 0, 0, 0, 0, nullptr,
+     waterCalibrationTest, nullptr, nullptr},
+    {MENU_ACTION, "3.Diagnostics", "", 0, 0, 0, 0, nullptr, showDiagnostics,
+     nullptr, nullptr},
+    {MENU_ACTION, "4.Event Log", "", 0, 0, 0, 0, nullptr, showEventLog,
+     nullptr, nullptr},
+    {MENU_ACTION, "5.Plant Profile", "", 0, 0, 0, 0, nullptr,
+     choosePlantProfile, nullptr, nullptr},
+    // {MENU_ACTION, "6.Disable Msgs", "", 0, 0, 0, 0, nullptr,
+    //  disableMessages, nullptr, nullptr},
+};
+
+constexpr MenuItem dateTimeForm[] PROGMEM = {
+    {MENU_NUMBER, "Set Year", "", 2000, 2099, 1, 0, &dateTimeValues[0],
+     nullptr, nullptr, nullptr},
+    {MENU_NUMBER, "Set Month", "", 1, 12, 1, 0, &dateTimeValues[1],
+     nullptr, nullptr, nullptr},
+    {MENU_NUMBER, "Set Day", "", 1, 31, 1, 0, &dateTimeValues[2],
+     nullptr, nullptr, nullptr},
+    {MENU_NUMBER, "Set Hour", "", 0, 23, 1, 0, &dateTimeValues[3],
+     nullptr, nullptr, nullptr},
+    {MENU_NUMBER, "Set Minute", "", 0, 59, 1, 0, &dateTimeValues[4],
+     nullptr, nullptr, nullptr},
+};
+
+constexpr MenuItem autoWateringForm[] PROGMEM = {
+    {MENU_NUMBER, "How much water?", "Cups: ", 5, 100, 5, 1, &doseTenthsOfCup,
+     applyDose, &doseRange, nullptr},
+    {MENU_NUMBER, "How frequent?", "Minutes: ", 1, plantMaxIntervalMin, 1, 0,
+     &waterIntervalHour, applyWaterInterval, &intervalRange, nullptr},
+};
+
+constexpr MenuItem calibrationForm[] PROGMEM = {
+    {MENU_NUMBER, "Water Duration", "(sec): ", 1, 600, 1, 0,
+     &calibrationSeconds, nullptr, nullptr, nullptr},
+    {MENU_NUMBER, "Pump Speed", "(%): ", Hw::pumpMinSpeedPercent, 100, 10, 0,
+     &calibrationSpeed, nullptr, nullptr, nullptr},
+};
+
+constexpr MenuItem calibrationVolumeForm[] PROGMEM = {
+    {MENU_NUMBER, "Volume output?", "(ml): ", 10, 5000, 10, 0,
+     &calibrationVolume, nullptr, nullptr, nullptr},
+};
+
+constexpr MenuItem plantForm[] PROGMEM = {
+    {MENU_NUMBER, "Plant Profile", "", 0, plantProfileCount - 1, 1, 0,
+     &plantChoice, applyPlantProfile, nullptr, plantChoiceName},
+};
+/** @} */
+
+static_assert(menuValid(settingsList) && menuValid(dateTimeForm) &&
+                  menuValid(autoWateringForm) && menuValid(calibrationForm) &&
+                  menuValid(calibrationVolumeForm) && menuValid(plantForm),
+              "menu table out of range");
+
 /**
  * @brief Initializes all hardware and peripherals
  * @details Performs system initialization including:
@@ -233,71 +443,284 @@ String getDate(const RtcDateTime &now);
 void setup() {
   lcd.init();
   lcd.backlight();
-  printMessage(2, 0, "Created by:");
-  printMessage(2, 1, "Quiyet Brul");
-  delay(2000);
+  animationBegin(lcd);
+  menuBegin(lcd);
+  animationQueue("Created by:", 2, 0, 0, ANIMATE_CLEAR);
+  animationQueue("Quiyet Brul", 2, 1, 2000);
 
   for (unsigned char i = 0; i < totalButtons; ++i) {
     pinMode(buttonPins[i], INPUT_PULLUP);
   }
 
-  pinMode(pinSoilPower, OUTPUT);
-  pinMode(pinSoilRead, INPUT_PULLUP);
-  pinMode(waterSensorPin, INPUT_PULLUP);
-  pinMode(waterDetectionPower, OUTPUT);
-  pinMode(pumpValvePin, OUTPUT);
-
-  digitalWrite(waterDetectionPower, LOW);
-  digitalWrite(pumpValvePin, LOW);
-  readSoilMoisture();
+  pumpDriveBegin();
+  soilBegin();
+  applyPlantProfile();
+  if (Hw::hasFloatSwitch) {
+    WaterLevelSwitch::inputPullup();
+  }
+  if (Hw::hasWaterDetectProbe) {
+    WaterDetectPower::output();
+    WaterDetectPower::low();
+  }
+  if (Hw::hasValve) {
+    PumpValve::output();
+    PumpValve::low();
+  }
+  flowBegin();
+  tankHadWater = isWaterDetected();
+  tankBegin(tankHadWater);
   rtc.Begin();
 
+  powerBegin();
+  Serial.begin(9600);
+#ifdef PROFILING
+  powerKeepSerialAwake(true);
+#endif
+  SupervisorFault resetBy = supervisorBegin();
+  eventLogBegin(rtc);
+  eventLogAdd(EVENT_BOOT, resetBy, 0);
+  if (resetBy == FAULT_WATCHDOG) {
+    handleFault(FAULT_WATCHDOG);
+    animationToast("Safety reset!", "Pump was stopped", transitionDelay);
+  }
+
   displayStartup();
-  lastMessageSwitch = millis();
+  lastUserActivity = millis();
+  lastMessageSwitch = lastUserActivity - messageDisplayDuration; // after it
 }
 
 /**
- * @brief Main program loop - handles water level checking and menu navigation
+ * @brief Main program loop - handles menu navigation
  * @details Core system loop that:
- * - Checks for low water level and displays warning
- * - Shows main menu cycling when no menu is active
+ * - Runs a watering requested over Serial
+ * - Shows main menu cycling (with any low-water banner) when no menu is active
  * - Processes button input for menu navigation
  * - Handles menu transitions and resets menu state
  */
 void loop() {
-  if (!isWaterDetected()) {
-    lcd.clear();
-    printMessage(0, 0, "Water Lvl Low!");
-    printMessage(0, 1, "Please add water");
-    delay(5000);
+  serviceTick();
+
+  if (currentMenu == 0 && wateringRequested) {
+    wateringRequested = false;
+    waterPlant(PUMP_REASON_REMOTE);
+    lastUserActivity = millis();
   } else if (currentMenu == 0) {
-    showMessageCycle();
-    checkButtons();
+    {
+      PROFILE_SCOPE(PROFILE_LOOP);
+      if (isBacklightOn) {
+        showMessageCycle();
+      }
+      checkButtons();
+    }
+    idleUntilNextEvent();
   } else {
     handleMenu(currentMenu);
     currentMenu = 0;
+    lastUserActivity = millis();
+  }
+
+#ifdef POWER_BENCHMARK
+  static unsigned long lastPowerReport = 0;
+  if (millis() - lastPowerReport >= 60000UL) {
+    lastPowerReport = millis();
+    powerReport(Serial);
+  }
+#endif
+}
+
+/**
+ * @brief Sleeps until the main menu has something to do
+ * @details Dims the LCD backlight after Hw::backlightTimeout without input,
+ * then power-down sleeps until the next message rotation, telemetry status or
+ * animation frame (or the longest watchdog period once dimmed). Naps instead
+ * while telemetry is still being sent. A button press wakes the MCU
+ * immediately, and so does the soil drying past the comparator's reference
+ * (sleepWatchingSoil()).
+ */
+void idleUntilNextEvent() {
+  if (currentMenu != 0) {
+    return;
+  }
+
+  unsigned long now = millis();
+  unsigned long sinceActivity = now - lastUserActivity;
+  if (isBacklightOn && sinceActivity >= Hw::backlightTimeout) {
+    lcd.noBacklight();
+    isBacklightOn = false;
+  }
+
+  unsigned long wait = 8000UL;
+  if (isBacklightOn) {
+    unsigned long sinceMessage = now - lastMessageSwitch;
+    wait = sinceMessage < messageDisplayDuration
+               ? messageDisplayDuration - sinceMessage
+               : 0;
+    wait = min(wait, Hw::backlightTimeout - sinceActivity);
+  }
+
+  unsigned long sinceStatus = now - lastTelemetryStatus;
+  wait = min(wait, sinceStatus < telemetryInterval
+                       ? telemetryInterval - sinceStatus
+                       : 0UL);
+  wait = min(wait, animationDueIn());
+  wait = min(wait, soilDueIn());
+  if (telemetryPending()) {
+    powerNap();
+    return;
+  }
+  sleepWatchingSoil(wait);
+}
+
+/**
+ * @brief Waits between clock screen passes
+ * @details inputDebounceDelay, busy. While the comparator watches the soil
+ * (soilWatching(), battery boards) it power-down sleeps instead, until the
+ * next colon blink, telemetry status, sampler work or watering; a button or
+ * the soil drying past the wake reference ends the sleep early.
+ */
+void clockIdle() {
+  if (!soilWatching() || telemetryPending()) {
+    delay(inputDebounceDelay);
+    return;
+  }
+  unsigned long now = millis();
+  unsigned long sinceBlink = now - lastBlink;
+  unsigned long wait =
+      sinceBlink < blinkInterval ? blinkInterval - sinceBlink : 0;
+  unsigned long sinceStatus = now - lastTelemetryStatus;
+  wait = min(wait, sinceStatus < telemetryInterval
+                       ? telemetryInterval - sinceStatus
+                       : 0UL);
+  wait = min(wait, soilDueIn());
+  wait = min(wait, millisUntilWatering());
+  if (wait < inputDebounceDelay) {
+    delay(inputDebounceDelay);
+    return;
+  }
+  sleepWatchingSoil(wait);
+}
+
+/**
+ * @brief powerSleep() with the comparator watching the soil when it can
+ * @param maxMs Longest time to sleep
+ * @details A wake by the soil takes the full sample at once, so the next
+ * autoWateringCheck() acts on it.
+ */
+void sleepWatchingSoil(unsigned long maxMs) {
+  powerSoilWake(soilWatching());
+  powerSleep(maxMs);
+  if (powerWokeBySoil()) {
+    soilRead(0);
+  }
+}
+
+/**
+ * @brief Background work shared by the main loop and menu polling loops
+ * @details Runs the safety supervisor (the only place the watchdog is fed, so
+ * every waiting loop must come through here), reconciles the tank model with
+ * the float switch, emits the periodic telemetry status record, draws due
+ * animation frames, drains the telemetry TX ring and answers Serial commands
+ * (profiler ones included), so none of them stall while a menu waits for
+ * input. Commands are only read once queued telemetry has gone out, so a text
+ * reply never lands inside a binary frame.
+ */
+void serviceTick() {
+  bool hasWater = isWaterDetected();
+  SupervisorFault fault =
+      supervisorPoll(isPumpRunning, hasWater && !injectedDryTank);
+  if (fault != FAULT_NONE) {
+    handleFault(fault);
+  }
+
+  tankUpdate(hasWater);
+  if (tankHasWater() != tankHadWater) {
+    tankHadWater = tankHasWater();
+    eventLogAdd(tankHadWater ? EVENT_REFILLED : EVENT_TANK_LOW, 0, 0);
+  }
+  if (millis() - lastTelemetryStatus >= telemetryInterval) {
+    lastTelemetryStatus = millis();
+    sendTelemetryStatus();
+  }
+  pumpDriveService();
+  soilService();
+  animationService();
+  lcd.service();
+  RECORD_SERVICE();
+  telemetryService();
+
+  SerialCommand command;
+  if (!telemetryPending() && commandPoll(command)) {
+    handleSerialCommand(command);
+  }
+}
+
+/**
+ * @brief Runs background services, then idles until the next interrupt
+ */
+void serviceNap() {
+  serviceTick();
+  powerNap();
+}
+
+/**
+ * @brief Waits, servicing in the meantime; use instead of delay() for waits
+ * long enough to matter to the watchdog
+ * @param ms Milliseconds to wait
+ */
+void serviceDelay(unsigned long ms) {
+  unsigned long start = millis();
+  while (millis() - start < ms) {
+    serviceNap();
   }
 }
 
+/**
+ * @brief Brings the application state in line after a supervisor fault
+ * @param fault What the supervisor found
+ * @details The supervisor has already zeroed the pump and closed the valve;
+ * this records the stop (telemetry, tank model) and reports the fault. A
+ * waiting runPump() sees the pump off and ends with PUMP_RUN_FAULT.
+ */
+void handleFault(SupervisorFault fault) {
+  pumpStop(false);
+#ifdef FAULT_INJECTION
+  injectedDryTank = false;
+#endif
+  eventLogAdd(EVENT_FAULT, fault, 0);
+
+  TelemetryFault record;
+  telemetryHeader(record.header, TELEMETRY_FAULT);
+  record.fault = fault;
+  record.count = supervisorFaultCount();
+  telemetrySend(&record, sizeof(record));
+}
+
 /**
  * @brief Displays the startup animation and welcome screen
- * @details Shows "Water Pump Menu" title followed by animated loading text
+ * @details Queues the "Water Pump Menu" title, the typed loading text and a
+ * pause before the main menu; a button press skips it
  */
 void displayStartup() {
-  printMessage(0, 0, "Water Pump Menu");
+  animationQueue("Water Pump Menu", 0, 0, 0, ANIMATE_CLEAR);
   printAnimation("    Loading...");
+  animationQueue(nullptr, 0, 0, messageDisplayDuration);
 }
 
 /**
  * @brief Cycles through main menu messages on the LCD display
  * @details Automatically rotates through the main menu options every N seconds
- * Updates the message index and refreshes the display when the timer expires
+ * Updates the message index and refreshes the display when the timer expires.
+ * The top row carries the low-water or refill banner when there is one.
+ * Holds off while an animation owns the LCD.
  */
 void showMessageCycle() {
+  if (animationActive()) {
+    return;
+  }
   if (millis() - lastMessageSwitch >= messageDisplayDuration) {
     lcd.noBlink();
     lcd.clear();
-    printMessage(4, 0, "MainMenu");
+    printMessage(0, 0, getMainMenuBanner());
     printMessage(0, 1, messagesHomeScreen[messageIndex]);
 
     messageIndex = (messageIndex + 1) % totalMessages;
@@ -309,7 +732,7 @@ void showMessageCycle() {
  * @brief Checks all navigation buttons and sets menu selection
  * @details Implements throttled button checking (every 10ms) to reduce CPU
  * usage Maps button presses to menu numbers: button 0→menu 1, button 1→menu 2,
- * etc.
+ * etc. While an animation is running a press skips it instead.
  */
 void checkButtons() {
   static unsigned long lastCheck = 0;
@@ -322,6 +745,21 @@ void checkButtons() {
 
   for (unsigned char i = 0; i < totalButtons; ++i) {
     if (isButtonPressed(buttonPins[i])) {
+      lastUserActivity = now;
+      if (!isBacklightOn) {
+        // First press only wakes the display
+        lcd.backlight();
+        isBacklightOn = true;
+        lastMessageSwitch = now - messageDisplayDuration;
+        break;
+      }
+      if (animationActive()) {
+        // A press during an animation only skips it
+        waitForRelease(buttonPins[i]);
+        animationSkip();
+        lastMessageSwitch = now - messageDisplayDuration;
+        break;
+      }
       currentMenu = i + 1;
       break;
     }
@@ -335,7 +773,13 @@ void checkButtons() {
  * main menu
  */
 void handleMenu(unsigned char menu) {
+  PROFILE_SCOPE(PROFILE_MENU);
   lcd.clear();
+  if (menu == 3) {
+    supervisorScreen(Hw::manualTimeoutSeconds);
+  } else {
+    supervisorScreen(Hw::screenTimeoutSeconds);
+  }
 
   switch (menu) {
   case 1:
@@ -354,8 +798,11 @@ void handleMenu(unsigned char menu) {
     lcd.print("Unknown Option");
   }
 
+  supervisorLeaveScreen();
   delay(100);
-  lcd.clear();
+  if (!animationActive()) {
+    lcd.clear(); // otherwise the exit message clears once it is done
+  }
 }
 
 /**
@@ -363,15 +810,21 @@ void handleMenu(unsigned char menu) {
  * @param pin Arduino pin number to check
  * @return true if button was pressed (with debouncing), false otherwise
  * @details Implements software debouncing with 100ms duration to prevent
- * false triggers from mechanical button bounce
+ * false triggers from mechanical button bounce. Once the supervisor asks the
+ * screen to exit (deadline passed), (A) reads as pressed.
  */
 bool isButtonPressed(unsigned char pin) {
-  if (millis() - lastTimeButtonStateChanged >= debounceDuration) {
-    byte buttonState = digitalRead(pin);
+  if (pin == Hw::buttonA && supervisorExitRequested()) {
+    return true;
+  }
+  if (millis() - lastTimeButtonStateChanged >= Hw::debounceDuration) {
+    byte buttonState = readPin(pin) ? HIGH : LOW;
+    RECORD_PIN(pin, buttonState);
     if (buttonState != lastButtonState) {
       lastTimeButtonStateChanged = millis();
       lastButtonState = buttonState;
       if (buttonState == LOW) {
+        supervisorActivity();
         return true;
       }
     }
@@ -379,6 +832,24 @@ bool isButtonPressed(unsigned char pin) {
   return false;
 }
 
+/**
+ * @brief Waits for a button to be released, servicing meanwhile
+ * @param pin Arduino pin number of the button
+ * @details Gives up after Hw::buttonReleaseTimeout, so a stuck or leaned-on
+ * button cannot hang the screen.
+ */
+void waitForRelease(unsigned char pin) {
+  unsigned long start = millis();
+  while (millis() - start < Hw::buttonReleaseTimeout) {
+    bool released = readPin(pin);
+    RECORD_PIN(pin, released);
+    if (released) {
+      break;
+    }
+    serviceNap();
+  }
+}
+
 /**
  * @brief Interactive clock display with moisture checking functionality
  * @details Shows cycling time/date display with options to check moisture level
@@ -386,46 +857,61 @@ bool isButtonPressed(unsigned char pin) {
  * - Cycles between time and date every few seconds
  * - Button 2: Measure and display current soil moisture
  * - Button 3: Exit menu or toggle auto watering mode
- * - Continuous auto watering check when enabled
+ * - Continuous auto watering check when enabled, also while an animation
+ *   (moisture reading, confirmation) is up; any button skips the animation
+ * - Between passes, sleeps while the comparator watches the soil (clockIdle())
+ * - Runs a watering requested over Serial (`w`)
  */
 void showClock() {
+  supervisorScreen(0); // Auto mode lives here: no deadline
   if (showInstructions) {
     printInstructions();
   }
 
   lastMessageSwitch = millis();
-  lcd.clear();
+  if (!animationActive()) {
+    lcd.clear();
+  }
 
+  static char reading[17]; // outlives the animation step that shows it
+  onClockScreen = true;
   while (true) {
-    showMessageCycleClock();
     autoWateringCheck();
+    if (wateringRequested) {
+      wateringRequested = false;
+      waterPlant(PUMP_REASON_REMOTE);
+    }
+
+    if (animationActive()) {
+      skipAnimationOnPress();
+      serviceTick();
+      delay(inputDebounceDelay);
+      continue;
+    }
+    showMessageCycleClock();
 
     // press M to measure moisture lvl
     if (isButtonPressed(buttonPins[em])) {
-      lcd.clear();
-      printMessage(0, 0, "Moisture Lvl:");
-      printAnimation("  Measuring...  ");
       readSoilMoisture();
-      delay(transitionDelay);
-      printMessage(0, 1, "                ");
-      printMessage(0, 1, getMoistureValue());
-      delay(messageDisplayDuration);
-      lcd.clear();
+      snprintf(reading, sizeof(reading), "%-16s", getMoistureValue().c_str());
+      animationQueue("Moisture Lvl:", 0, 0, 0, ANIMATE_CLEAR);
+      printAnimation("  Measuring...  ");
+      animationQueue(nullptr, 0, 0, transitionDelay);
+      animationQueue(reading, 0, 1, messageDisplayDuration);
       continue;
     }
     if (isButtonPressed(buttonPins[aye])) {
       if (isAutoModeEnabled) {
-        lcd.clear();
-        printMessage(2, 0, "[Auto Mode]");
-        delay(500);
-        printMessage(2, 1, "Disabled :(");
         isAutoModeEnabled = false;
-        delay(2000);
+        animationQueue("[Auto Mode]", 2, 0, 500, ANIMATE_CLEAR);
+        animationQueue("Disabled :(", 2, 1, 2000);
       }
       printExitCurrentMenu();
+      onClockScreen = false;
       return;
     }
-    delay(inputDebounceDelay);
+    serviceTick();
+    clockIdle();
   }
 }
 
@@ -443,6 +929,7 @@ void showMessageCycleClock() {
   }
 
   RtcDateTime now = rtc.GetDateTime();
+  RECORD_RTC(now.TotalSeconds());
   printMessage(0, 0, getTime(now));
   printMessage(10, 0, getMoistureValue());
   printMessage(0, 1, getDate(now));
@@ -456,15 +943,7 @@ void showMessageCycleClock() {
     printMessage(0, 1, "                ");
   }
 
-  unsigned long elaspedTime = nowMs - autoTimer;
-  unsigned long remainingTime = 0;
-  unsigned long intervalMilli = waterInterval * 1000;
-
-  if (elaspedTime < intervalMilli) {
-    remainingTime = intervalMilli - elaspedTime;
-  }
-
-  unsigned long totalSecondsRemaining = remainingTime / 1000;
+  unsigned long totalSecondsRemaining = millisUntilWatering() / 1000;
   unsigned long hoursPart = totalSecondsRemaining / 3600UL;
   unsigned long minutesPart = (totalSecondsRemaining % 3600UL) / 60UL;
   printMessage(0, 1, "Feeds in: ");
@@ -474,61 +953,143 @@ void showMessageCycleClock() {
 
 /**
  * @brief Manual watering mode with interactive pump control
- * @details Provides manual control interface for pump operation with real-time
- * moisture monitoring. Features include:
- * - Continuous moisture level display
- * - Button 2: Activate pump manually
+ * @details The pump runs while (M) is held, switched from the button
+ * interrupt (ManualPump.h) so it starts and stops within microseconds of
+ * press and release:
+ * - Safety sensors stay warm while the screen is open: the spill probe is
+ *   powered throughout and re-read every manualProbeInterval, the soil comes
+ *   from the background sampler and the float switch is read on each edge
+ * - Any failed check disarms the button (stopping the pump) until it passes
+ * - A single hold stops after Hw::manualMaxHoldMs; release to water again
+ * - The first row shows the on-time and volume delivered since the screen
+ *   opened, live while watering
  * - Button 3: Exit manual mode
- * - Real-time feedback during pump operation
- * - Safety delays to prevent pump damage
  */
 void manualWatering() {
   if (showInstructions) {
     printInstructions();
   }
 
-  delay(500);
-
-  while (isPlantOkayToWater()) {
-    lcd.clear();
-    printMessage(1, 0, "Manual Water");
-    printMessage(0, 1, "(M)Hold (A):Esc ");
+  if (!isPlantOkayToWater()) {
+    return;
+  }
+  if (Hw::hasWaterDetectProbe) {
+    WaterDetectPower::high(); // warm from here on; read without waiting
+  }
+  unsigned long probeReadAt = millis();
+  const uint8_t pwm = Hw::pumpHighSetting;
+  manualPumpBegin(pwm);
+
+  unsigned long totalMs = 0; ///< On-time of finished holds
+  unsigned int totalMl = 0;  ///< Volume of finished holds
+  bool booked = false;       ///< pumpStarted() recorded for the current hold
+  bool wateredYet = false;
+  bool totalsStale = false;  ///< First row behind the totals
+  const char *notice = nullptr; ///< Why the last hold was cut short
+  const char *shown = nullptr;  ///< Second row on the LCD
+  unsigned long lastTotals = 0;
+  bool drawn = false;
 
-    bool currentlyWatering = false;
+  while (true) {
+    manualPumpPoll();
+    unsigned long now = millis();
 
-    while (true) {
-      delay(inputDebounceDelay);
-      bool isMHeld = (digitalRead(buttonPins[em]) == LOW);
-
-      // Handle pump state changes
-      if (isMHeld != currentlyWatering) {
-        currentlyWatering = isMHeld;
-
-        // Control pump based on current state
-        if (currentlyWatering && isPlantOkayToWater()) {
-          printMessage(2, 1, "Watering...   ");
-          digitalWrite(pumpValvePin, HIGH);
-          analogWrite(pumpPin, pumpHighSetting);
-        } else {
-          printMessage(0, 1, "(M)Hold (A):Esc ");
-          analogWrite(pumpPin, 0);
-          digitalWrite(pumpValvePin, LOW);
-        }
+    if (Hw::hasWaterDetectProbe && now - probeReadAt >= manualProbeInterval) {
+      probeReadAt = now;
+      lastWaterDetectValue = analogRead(Hw::waterDetectRead);
+      RECORD_ANALOG(Hw::waterDetectRead, lastWaterDetectValue);
+    }
+    const char *unsafe = nullptr;
+    if (!isWaterDetected() || injectedDryTank) {
+      unsafe = "Water Lvl Low!  ";
+    } else if (soilLatest().raw >= plant.wetRaw) {
+      unsafe = "Soil now wet    ";
+    } else if (pumpHeatHeadroomMs(pwm) == 0) {
+      unsafe = "Pump too hot    ";
+    } else if (Hw::hasWaterDetectProbe &&
+               lastWaterDetectValue > waterDetectThreshold) {
+      unsafe = "Water detected! ";
+    }
+    manualPumpArm(unsafe == nullptr);
+    RECORD_PIN(Hw::buttonM, !ButtonM::isLow());
+
+    // Book what the interrupt did; stop what it must not keep doing
+    if (booked && !isPumpRunning) {
+      manualPumpStop(); // the supervisor cut it (runtime cap, tank low)
+      notice = "Safety stop!    ";
+    } else if (booked && manualPumpOn() &&
+               now - pumpStartedAt >= Hw::manualMaxHoldMs) {
+      manualPumpStop();
+      notice = "Max hold reached";
+    }
+    if (manualPumpOn() && !booked) {
+      pumpStarted(PUMP_REASON_MANUAL, pwm, manualPumpChangedAt());
+      booked = true;
+      wateredYet = true;
+      notice = nullptr;
+    } else if (!manualPumpOn() && booked) {
+      unsigned long onMs = manualPumpChangedAt() - pumpStartedAt;
+      totalMs += onMs;
+      totalMl += Hw::hasFlowMeter
+                     ? flowPulsesToMillilitres(flowPulses() - pumpStartPulses)
+                     : estimateVolumeMl(pwm, onMs);
+      if (isPumpRunning) {
+        pumpStopped(manualPumpChangedAt());
       }
+      booked = false;
+      totalsStale = true;
+    }
 
-      // Handle exit button
-      if (isButtonPressed(buttonPins[aye])) {
-        // Stop pump if currently watering
-        if (currentlyWatering) {
-          analogWrite(pumpPin, 0);
-          digitalWrite(pumpValvePin, LOW);
+    // Redraw once a warning from isPlantOkayToWater() has cleared
+    if (animationActive()) {
+      drawn = false;
+    } else {
+      if (!drawn) {
+        lcd.clear();
+        printMessage(1, 0, "Manual Water");
+        shown = nullptr;
+        totalsStale = wateredYet;
+        drawn = true;
+      }
+      const char *row = unsafe != nullptr   ? unsafe
+                        : booked            ? "Watering...     "
+                        : notice != nullptr ? notice
+                                            : "(M)Hold (A):Esc ";
+      if (row != shown) {
+        printMessage(0, 1, row);
+        shown = row;
+      }
+      if ((booked || totalsStale) && now - lastTotals >= 200) {
+        lastTotals = now;
+        totalsStale = false;
+        unsigned long ms = totalMs;
+        unsigned int ml = totalMl;
+        if (booked) {
+          ms += now - pumpStartedAt;
+          ml += Hw::hasFlowMeter
+                    ? flowPulsesToMillilitres(flowPulses() - pumpStartPulses)
+                    : estimateVolumeMl(pwm, now - pumpStartedAt);
         }
-        printExitCurrentMenu();
-        return;
+        char line[17];
+        snprintf(line, sizeof(line), "%4lu.%lus %5uml ", ms / 1000 % 10000,
+                 ms / 100 % 10, ml % 100000U);
+        printMessage(0, 0, line);
       }
+    }
 
-      delay(50);
+    if (isButtonPressed(buttonPins[aye])) {
+      manualPumpEnd();
+      if (booked && isPumpRunning) {
+        pumpStopped(manualPumpChangedAt());
+      }
+      if (Hw::hasWaterDetectProbe) {
+        WaterDetectPower::low();
+      }
+      printExitCurrentMenu();
+      return;
     }
+
+    serviceNap();
   }
 }
 
@@ -548,440 +1109,1068 @@ void autoWatering() {
     printInstructions();
   }
 
-  float targetCups = 1.0;
-  float stepp = 0.5;
-
-  if (oneCupCalibrated <= 0) {
-    lcd.clear();
-    printMessage(0, 0, "Calibration");
-    printMessage(0, 1, "Needed...");
-    delay(1500);
+  if (!hasDoseCalibration()) {
+    animationToast("Calibration", "Needed...", 1500);
+    waitForAnimation();
     waterCalibrationTest();
   }
 
-  if (oneCupCalibrated <= 0) {
+  if (!hasDoseCalibration()) {
     return;
   }
 
-  delay(500);
-
-  enum SettingStep { SET_VALUE, SET_FREQUENCY, DONE };
-  SettingStep step = SET_VALUE;
-
-  while (step != DONE) {
-    lcd.clear();
-
-    if (step == SET_VALUE) {
-      printMessage(0, 0, "How much water?");
-      printMessage(0, 1, "Cups: ");
-      lcd.print(targetCups, 1);
-
-      while (true) {
-        // Handle increment/decrement
-        int direction = 0;
-        if (isButtonPressed(buttonPins[minus]))
-          direction = -1;
-        if (isButtonPressed(buttonPins[plus]))
-          direction = 1;
-
-        if (direction != 0) {
-          while (digitalRead(buttonPins[abs(direction)]) == LOW)
-            ;
-          targetCups = constrain(targetCups + (direction * stepp), 0.5, 10.0);
-          break;
-        }
-
-        if (isButtonPressed(buttonPins[em])) {
-          autoWaterDurationMillis =
-              (unsigned long)(targetCups * oneCupCalibrated);
-          waterDuration = autoWaterDurationMillis;
-          step = SET_FREQUENCY;
-          break;
-        }
-
-        if (isButtonPressed(buttonPins[aye])) {
-          printExitCurrentMenu();
-          return;
-        }
-      }
-      delay(50);
-    }
-
-    if (step == SET_FREQUENCY) {
-      printMessage(0, 0, "How frequent?");
-      printMessage(0, 1, "Minutes: " + waterIntervalHour / 60);
-
-      while (true) {
-        // Handle increment/decrement
-        int direction = 0;
-        if (isButtonPressed(buttonPins[minus]))
-          direction = -1;
-        if (isButtonPressed(buttonPins[plus]))
-          direction = 1;
-
-        if (direction != 0) {
-          unsigned int newInterval =
-              waterIntervalHour + (direction * waterIntervalDelta);
-          waterIntervalHour = constrain(newInterval, waterIntervalDelta, 1440);
-          break;
-        }
-
-        if (isButtonPressed(buttonPins[em])) {
-          waterInterval = waterIntervalHour;
-          step = DONE;
-          break;
-        }
-
-        if (isButtonPressed(buttonPins[aye])) {
-          printExitCurrentMenu();
-          return;
-        }
-      }
-      delay(100);
-    }
+  menuOpen(autoWateringForm);
+  if (runMenu() == MENU_CANCELLED) {
+    printExitCurrentMenu();
+    return;
   }
 
   isAutoModeEnabled = true;
-  autoTimer = 0;
-  lcd.clear();
-  printMessage(0, 0, "  [Auto Mode]");
-  delay(500);
-  printMessage(0, 1, "  Enabled :)");
-  delay(2000);
   autoTimer = millis();
+  windowCancel();
+  heatRemainder.durationMs = 0;
+  animationQueue("  [Auto Mode]", 0, 0, 500, ANIMATE_CLEAR);
+  animationQueue("  Enabled :)", 0, 1, 2000);
 
   showClock();
 }
 
 /**
  * @brief Executes a complete watering cycle
+ * @param reason TelemetryPumpReason reported with the pump records
  * @details Performs the physical watering operation with safety checks:
  * - Verifies plant is safe to water before starting
- * - Opens valve, runs pump for configured duration
+ * - Opens valve, runs pump for the dose, planned from the calibration curve
+ *   (PWM and time) when a volume is set
  * - Closes valve and provides user feedback
  * - Uses proper timing delays to protect pump hardware
+ * - Keeps the pump within its heat budget: runs only the part of the dose
+ *   that fits, and in auto mode queues the rest (or the whole dose, if too
+ *   little fits to be worth a start) for when the pump has cooled; the next
+ *   watering delivers it. A rest shorter than Hw::pumpMinDoseMs is dropped,
+ *   and so is any rest when the run ends on an abort, fault or flow problem
+ * - Logs why the watering was skipped, if it was
  */
-void waterPlant() {
+void waterPlant(uint8_t reason) {
   if (isPlantOkayToWater()) {
+    PROFILE_SCOPE(PROFILE_WATER);
+    PumpPlan plan = {Hw::pumpHighSetting, waterDuration};
+    unsigned int volumeMl = waterVolumeMl;
+    if (heatRemainder.durationMs > 0) {
+      plan = heatRemainder;
+      volumeMl = heatRemainderMl;
+      heatRemainder.durationMs = 0;
+    } else if (volumeMl > 0) {
+      pumpCurvePlan(volumeMl, plan);
+    }
+
+    unsigned long headroom = pumpHeatHeadroomMs(plan.pwm);
+    unsigned long runMs = min(plan.durationMs, headroom);
+    unsigned int runMl = volumeMl;
+    if (runMs < plan.durationMs) {
+      if (runMs < Hw::pumpMinDoseMs) {
+        runMs = 0;
+      }
+      runMl = static_cast<unsigned long>(volumeMl) * runMs / plan.durationMs;
+      if (isAutoModeEnabled && plan.durationMs - runMs >= Hw::pumpMinDoseMs) {
+        heatRemainder.pwm = plan.pwm;
+        heatRemainder.durationMs = plan.durationMs - runMs;
+        heatRemainderMl = volumeMl - runMl;
+      }
+    }
+    if (runMs == 0) {
+      deferHeatRemainder(reason);
+      animationToast("Pump cooling...",
+                     isAutoModeEnabled ? "Watering later" : "Try again later",
+                     exitDelay);
+      return;
+    }
+
+    animationSkip();
     lcd.clear();
     printMessage(0, 0, "Watering plant..");
-    digitalWrite(pumpValvePin, HIGH);
-    delay(pumpValveTiming);
-    analogWrite(pumpPin, pumpHighSetting);
-    delay(waterDuration);
-    analogWrite(pumpPin, 0);
-    delay(pumpValveTiming);
-    digitalWrite(pumpValvePin, LOW);
-    lcd.clear();
-    printMessage(0, 0, "Done!");
-    delay(exitDelay);
-    lcd.clear();
+    pumpStart(true, reason, plan.pwm);
+    PumpRunResult result = runPump(runMs, runMl);
+    pumpStop(true);
+    windowRan();
+    if (result == PUMP_RUN_DONE || result == PUMP_RUN_HOT) {
+      deferHeatRemainder(reason);
+    } else {
+      heatRemainder.durationMs = 0; // Stopped short: don't pump the rest
+    }
+    if (result == PUMP_RUN_DONE && runMs < plan.durationMs) {
+      result = PUMP_RUN_HOT;
+    }
+    switch (result) {
+    case PUMP_RUN_DONE:
+      animationToast("Done!", "", exitDelay);
+      break;
+    case PUMP_RUN_HOT:
+      animationToast("Pump hot!", heatRemainder.durationMs > 0
+                                      ? "Rest after cooling"
+                                      : "Dose cut short",
+                     exitDelay);
+      break;
+    case PUMP_RUN_ABORTED:
+      animationToast("Stopped!", "", exitDelay);
+      break;
+    case PUMP_RUN_STALLED:
+      animationToast("No flow!", "Check pump/hose", exitDelay);
+      break;
+    case PUMP_RUN_TIMEOUT:
+      animationToast("Low flow!", "Dose cut short", exitDelay);
+      break;
+    case PUMP_RUN_FAULT:
+      animationToast("Safety stop!", isWaterDetected() ? "Pump time limit"
+                                                       : "Tank ran low",
+                     exitDelay);
+      break;
+    }
+    return;
   }
+
+  uint16_t value = 0;
+  if (lastWaterBlock == EVENT_SKIP_WET) {
+    value = moistureLevel;
+  } else if (lastWaterBlock == EVENT_SKIP_SPILL) {
+    value = lastWaterDetectValue;
+  }
+  eventLogAdd(lastWaterBlock, reason, value);
 }
 
 /**
- * @brief Automatic watering timer check and execution
- * @details Monitors the automatic watering schedule when auto mode is enabled
- * Triggers watering when the configured interval has elapsed since last
- * watering Uses waterInterval (in seconds) to determine watering frequency
+ * @brief Queues the rest of a split dose for when the pump has cooled
+ * @param reason TelemetryPumpReason it runs with
+ * @details Nothing to do unless waterPlant() kept a remainder (auto mode
+ * only). The rest follows after the cool-down whatever the watering window:
+ * it belongs to a watering that already started.
  */
-void autoWateringCheck() {
-  if (isAutoModeEnabled && (millis() - autoTimer >= waterInterval * 1000)) {
-    waterPlant();
-    autoTimer = millis();
+void deferHeatRemainder(uint8_t reason) {
+  if (heatRemainder.durationMs == 0) {
+    return;
   }
+  windowRetry(reason, pumpCoolDownMs(heatRemainder.durationMs,
+                                     heatRemainder.pwm));
 }
 
 /**
- * @brief Interactive settings configuration menu
- * @details Provides user interface for adjusting system parameters:
- * - Moisture threshold adjustment (up/down buttons)
- * - Real-time threshold display with percentage
- * - Persistent settings storage during session
- * - Exit option to return to main menu
- * Allows fine-tuning of automatic watering sensitivity
+ * @brief Keeps the pump running until the dose is delivered
+ * @param durationMs Run time; with a volume set, the fallback is 1.5x this
+ * @param volumeMl Target volume from the flow meter, 0 for a timed run
+ * @return How the run ended
+ * @details The caller starts and stops the pump; this only waits, servicing
+ * telemetry and Serial commands so the run can be aborted remotely. With a
+ * flow meter fitted, Hw::flowStallTimeout without a pulse ends any run.
+ * The supervisor can stop the pump at any service tick, and the run ends as
+ * soon as the pump has used up its heat budget.
  */
-void settingsMenu() {
-  if (showInstructions) {
-    printInstructions();
-  }
-
-  const unsigned char totalSettings = 3;
-  unsigned char selected = 0;
-  unsigned char lastSelected = 255; // Force initial display
-
-  String options[totalSettings] = {"1.Set Time/Date", "2.Calibrate Test"/*,
-                                   "3.Disable Msgs"*/};
+PumpRunResult runPump(unsigned long durationMs, unsigned int volumeMl) {
+  bool metered = Hw::hasFlowMeter && volumeMl > 0;
+  unsigned long limit = metered ? durationMs + durationMs / 2 : durationMs;
+  unsigned long start = millis();
+  unsigned long lastFlow = start;
+  uint32_t startPulses = flowPulses();
+  uint32_t lastPulses = startPulses;
 
   while (true) {
-    // Only update display when selection changes
-    if (selected != lastSelected) {
-      lcd.clear();
-      printMessage(0, 0, "Select Option:");
-      printMessage(0, 1, options[selected]);
-      lastSelected = selected;
+    unsigned long now = millis();
+    if (!isPumpRunning) {
+      return PUMP_RUN_FAULT;
     }
-
-    delay(inputDebounceDelay);
-
-    // Check all buttons and handle appropriately
-    for (unsigned char i = 0; i < totalButtons; i++) {
-      if (isButtonPressed(buttonPins[i])) {
-        while (digitalRead(buttonPins[i]) == LOW)
-          ; // Wait for release
-
-        switch (i) {
-        case 0: // Previous option
-          selected = (selected == 0) ? totalSettings - 1 : selected - 1;
-          break;
-        case 1: // Next option
-          selected = (selected + 1) % totalSettings;
-          break;
-        case 2: // Select/Confirm
-          switch (selected) {
-          case 0:
-            setDateTime();
-            break;
-          case 1:
-            waterCalibrationTest();
-            break;
-            // case 2:
-            //   disableMessages();
-            //   break;
-          }
-          return;
-        case 3: // Exit
-          printExitCurrentMenu();
-          return;
-        }
-        break; // Exit the for loop once a button is handled
+    if (wateringAbortRequested) {
+      wateringAbortRequested = false;
+      return PUMP_RUN_ABORTED;
+    }
+    if (pumpHeatHeadroomMs(pumpPwm) == 0) {
+      return PUMP_RUN_HOT;
+    }
+    if (Hw::hasFlowMeter) {
+      uint32_t pulses = flowPulses();
+      if (pulses != lastPulses) {
+        lastPulses = pulses;
+        lastFlow = now;
+      } else if (now - lastFlow >= Hw::flowStallTimeout) {
+        return PUMP_RUN_STALLED;
+      }
+      if (metered &&
+          flowPulsesToMillilitres(pulses - startPulses) >= volumeMl) {
+        return PUMP_RUN_DONE;
       }
     }
-
-    delay(50);
+    if (now - start >= limit) {
+      return metered ? PUMP_RUN_TIMEOUT : PUMP_RUN_DONE;
+    }
+    serviceNap();
   }
 }
 
 /**
- * @brief Sets the date and time on the RTC module
- * @details Interactive interface for setting year, month, day, hour, and
- * minute Uses increment/decrement buttons to adjust values and saves to RTC
+ * @brief Automatic watering timer check and execution
+ * @details Monitors the automatic watering schedule when auto mode is enabled
+ * Triggers watering when the configured interval has elapsed since last
+ * watering Uses waterInterval (in minutes) to determine watering frequency.
+ * Soil that has dried below the plant profile's band is watered early, once
+ * the profile's minimum spacing has passed and within its preferred hours;
+ * the schedule then restarts from that watering.
+ * A due watering runs only within the watering windows, batched with any
+ * other due or just made (see WateringWindow.h).
  */
-void setDateTime() {
-  int year = 2025;
-  int month = 1;
-  int day = 1;
-  int hour = 12;
-  int minute = 0;
-
-  enum Step { SET_YEAR, SET_MONTH, SET_DAY, SET_HOUR, SET_MINUTE, DONE };
-  Step step = SET_YEAR;
-  Step lastStep = DONE; // Force initial display
-
-  while (step != DONE) {
-    // Only update display when step changes
-    if (step != lastStep) {
-      lcd.clear();
-      char buffer[17]; // 16 chars + null terminator
-
-      switch (step) {
-      case SET_YEAR:
-        sprintf(buffer, "Set Year: %d", year);
-        break;
-      case SET_MONTH:
-        sprintf(buffer, "Set Month: %d", month);
-        break;
-      case SET_DAY:
-        sprintf(buffer, "Set Day: %d", day);
-        break;
-      case SET_HOUR:
-        sprintf(buffer, "Set Hour: %d", hour);
-        break;
-      case SET_MINUTE:
-        sprintf(buffer, "Set Minute: %d", minute);
-        break;
-      default:
-        break;
+void autoWateringCheck() {
+  if (!isAutoModeEnabled) {
+    return;
+  }
+  if (!windowPending()) {
+    static bool offHours = false;        ///< Last hour check said no
+    static unsigned long offHoursAt = 0; ///< millis() of that check
+    unsigned long elapsed = millis() - autoTimer;
+    uint8_t reason = PUMP_REASON_SCHEDULE;
+    bool dry = elapsed < wateringIntervalMillis();
+    if (dry && (elapsed < plant.minSpacingMs ||
+                soilLatest().raw >= plant.dryRaw ||
+                (offHours && millis() - offHoursAt < 60000UL))) {
+      return;
+    }
+    RtcDateTime now = rtc.GetDateTime();
+    RECORD_RTC(now.TotalSeconds());
+    if (dry) {
+      offHours = !plantPrefersHour(now.Hour());
+      if (offHours) {
+        offHoursAt = millis();
+        return;
       }
-
-      printMessage(0, 0, buffer);
-      printMessage(0, 1, "(-)(+)(M)Next");
-      lastStep = step;
+      reason = PUMP_REASON_DRY;
+    }
+    if (!windowQueue(reason, now)) {
+      autoTimer = millis(); // folded into the run just made
+      return;
     }
+  }
 
-    bool buttonHandled = false;
+  uint8_t reason;
+  if (windowReady(reason)) {
+    waterPlant(reason);
+    autoTimer = millis();
+  }
+}
 
-    // finished setting date and time
-    if (isButtonPressed(buttonPins[aye])) {
-      printExitCurrentMenu();
+/**
+ * @brief Reports whether a dose in cups can be turned into a pump run
+ * @return true with a flow meter, a calibration curve or a one-cup time
+ */
+bool hasDoseCalibration() {
+  return Hw::hasFlowMeter || oneCupCalibrated > 0 ||
+         pumpCurveSize(PUMP_CURVE_TIME) > 0;
+}
+
+/**
+ * @brief Sets the watering dose by volume
+ * @param volumeMl Dose in millilitres
+ * @details waterPlant() plans the run from the calibration curve. The run
+ * time set here is what is used without a curve, and the fallback limit for
+ * a metered run: scaled from the one-cup time, or Hw::flowFallbackMsPerCup.
+ */
+void setDoseMillilitres(unsigned int volumeMl) {
+  unsigned long msPerCup =
+      oneCupCalibrated > 0 ? oneCupCalibrated : Hw::flowFallbackMsPerCup;
+  waterVolumeMl = volumeMl;
+  waterDuration = (unsigned long)volumeMl * msPerCup / millilitresPerCup;
+}
+
+/**
+ * @brief Volume a pump run delivers, from calibration
+ * @param pwm Duty of the run
+ * @param durationMs Length of the run
+ * @return Millilitres, or 0 when uncalibrated
+ */
+unsigned int estimateVolumeMl(uint8_t pwm, unsigned long durationMs) {
+  unsigned int volume = pumpCurveVolume(pwm, durationMs);
+  if (volume == 0 && oneCupCalibrated > 0 && pwm == Hw::pumpHighSetting) {
+    volume = durationMs * millilitresPerCup / oneCupCalibrated;
+  }
+  return volume;
+}
+
+/**
+ * @brief Volume the auto-mode schedule dispenses per day
+ * @return Millilitres per day, 0 when auto mode is off or uncalibrated
+ */
+unsigned long dailyWaterUseMl() {
+  if (!isAutoModeEnabled || waterInterval == 0) {
+    return 0;
+  }
+  unsigned long doseMl = waterVolumeMl;
+  if (doseMl == 0) {
+    doseMl = estimateVolumeMl(Hw::pumpHighSetting, waterDuration);
+  }
+  return doseMl * 1440UL / waterInterval;
+}
+
+/**
+ * @brief Auto-mode watering interval
+ * @return waterInterval (minutes) in milliseconds
+ */
+unsigned long wateringIntervalMillis() { return waterInterval * 60000UL; }
+
+/**
+ * @brief Time left until the next scheduled watering
+ * @return Milliseconds until autoWateringCheck() waters, 0 if due or off
+ * @details A watering waiting for its window counts down to the window.
+ */
+unsigned long millisUntilWatering() {
+  if (!isAutoModeEnabled) {
+    return 0;
+  }
+  if (windowPending()) {
+    return windowDueIn();
+  }
+  unsigned long elapsed = millis() - autoTimer;
+  unsigned long interval = wateringIntervalMillis();
+  return elapsed < interval ? interval - elapsed : 0;
+}
+
+/**
+ * @brief Queues a telemetry status record
+ * @details Reports the latest moisture (with its age) and spill-probe
+ * readings rather than sampling, so the probes are not powered just for
+ * telemetry.
+ */
+void sendTelemetryStatus() {
+  TelemetryStatus record;
+  telemetryHeader(record.header, TELEMETRY_STATUS);
+  SoilSample soil = soilLatest();
+  record.moistureRaw = soil.raw;
+  record.moisturePercent = calculateMoisture(soil.raw);
+  record.moistureAgeS = min(soil.ageMs / 1000UL, 0xFFFFUL);
+  record.waterDetectRaw = lastWaterDetectValue;
+  record.flags = 0;
+  if (isPumpRunning) {
+    record.flags |= TELEMETRY_FLAG_PUMP;
+  }
+  if (Hw::hasValve && PumpValve::read()) {
+    record.flags |= TELEMETRY_FLAG_VALVE;
+  }
+  if (isAutoModeEnabled) {
+    record.flags |= TELEMETRY_FLAG_AUTO;
+  }
+  if (isWaterDetected()) {
+    record.flags |= TELEMETRY_FLAG_TANK_OK;
+  }
+  if (isBacklightOn) {
+    record.flags |= TELEMETRY_FLAG_BACKLIGHT;
+  }
+  if (windowPending()) {
+    record.flags |= TELEMETRY_FLAG_DEFERRED;
+  }
+  record.intervalMinutes = waterInterval;
+  record.secondsToWatering = millisUntilWatering() / 1000UL;
+  record.tankMl = tankRemainingMl();
+  record.hoursToLow = tankHoursToLow(dailyWaterUseMl());
+  record.droppedFrames = telemetryDropped();
+  telemetrySend(&record, sizeof(record));
+}
+
+/**
+ * @brief Setting keys understood by the Serial g/s commands
+ * @details
+ * - iv: auto-mode interval (minutes, from the profile's spacing to a week)
+ * - dm: timed watering dose (ms)
+ * - vm: dose by volume (ml); dc: the same in tenths of a cup (need
+ *   calibration), both up to the profile's largest dose
+ * - th: moisture (%) from which watering is skipped; set by the profile
+ * - wd: spill-probe reading above which watering is blocked
+ * - ca: calibrated run time for one cup (ms)
+ * - ct: full-speed calibration points, pairs of run time (ms) and volume (ml)
+ * - cf: speed calibration points, pairs of PWM duty and flow (ml/min)
+ * - pp: plant profile (library entry, see PlantProfile.h)
+ * - wn: watering windows, up to three pairs of start and end hour (0-24);
+ *   a start after its end wraps past midnight
+ * - wb: batch time (minutes): a watering due this soon after a run is folded
+ *   into it
+ * - am: auto mode (0/1)
+ * - rt: RTC date and time (year month day hour minute second)
+ * - lm: mirror the LCD frame over Serial (0/1)
+ * - tk: estimated tank volume (ml); reading it also gives hours to low
+ */
+const uint16_t settingKeys[] = {
+    commandKey('i', 'v'), commandKey('d', 'm'), commandKey('d', 'c'),
+    commandKey('t', 'h'), commandKey('w', 'd'), commandKey('c', 'a'),
+    commandKey('a', 'm'), commandKey('r', 't'), commandKey('l', 'm'),
+    commandKey('v', 'm'), commandKey('c', 't'), commandKey('c', 'f'),
+    commandKey('t', 'k'), commandKey('p', 'p'), commandKey('w', 'n'),
+    commandKey('w', 'b'),
+};
+
+/**
+ * @brief Executes one line of the Serial command protocol
+ * @param command Decoded line
+ * @details Verbs:
+ * - `g [key]`: print one setting, or all of them
+ * - `s key value...`: change a setting and echo it back
+ * - `w`: water now (runs from the main menu once any open menu closes)
+ * - `x`: abort a running or pending watering
+ * - `l`: print the event log, oldest first
+ * - `?`: list verbs and keys
+ * - `f fault`: trigger a supervisor fault (FAULT_INJECTION builds only)
+ * Failures answer `ERR` followed by a reason.
+ */
+void handleSerialCommand(const SerialCommand &command) {
+  if (command.error) {
+    Serial.print(F("ERR syntax"));
+    commandEndReply();
+    return;
+  }
+
+  switch (command.verb) {
+  case 'g':
+    if (command.key == 0) {
+      for (unsigned char i = 0; i < sizeof(settingKeys) / sizeof(settingKeys[0]);
+           ++i) {
+        printSetting(settingKeys[i]);
+      }
+      return;
+    }
+    if (!printSetting(command.key)) {
+      Serial.print(F("ERR key"));
+      commandEndReply();
+    }
+    return;
+  case 's':
+    if (!applySetting(command)) {
+      Serial.print(F("ERR value"));
+      commandEndReply();
       return;
     }
+    printSetting(command.key);
+    return;
+  case 'w':
+    if (!isWaterDetected()) {
+      Serial.print(F("ERR tank"));
+      break;
+    }
+    // Only the main menu and the clock screen run a requested watering
+    if (isPumpRunning || (currentMenu != 0 && !onClockScreen)) {
+      Serial.print(F("ERR busy"));
+      break;
+    }
+    wateringRequested = true;
+    Serial.print(F("OK"));
+    break;
+  case 'x':
+    wateringRequested = false;
+    wateringAbortRequested = isPumpRunning || pumpStarting;
+    windowCancel();
+    heatRemainder.durationMs = 0;
+    Serial.print(F("OK"));
+    break;
+  case 'l':
+    printEventLog();
+    return;
+  case '?':
+    Serial.print(
+        F("g [key] | s key val.. | w | x | l  keys: iv dm vm dc th wd ca ct cf am rt lm tk pp wn wb"));
+    break;
+#ifdef PROFILING
+  case 'p':
+    profileDump(Serial);
+    Serial.print(F("OK"));
+    break;
+  case 'r':
+    profileReset();
+    Serial.print(F("OK"));
+    break;
+#endif
+#ifdef FAULT_INJECTION
+  case 'f':
+    if (command.argc != 1 || !injectFault(command.argv[0])) {
+      Serial.print(F("ERR value"));
+      break;
+    }
+    return;
+#endif
+  default:
+    Serial.print(F("ERR verb"));
+    break;
+  }
+  commandEndReply();
+}
 
-    // finish setting current step
-    if (isButtonPressed(buttonPins[em])) {
-      step = static_cast<Step>(step + 1);
-      buttonHandled = true;
+/**
+ * @brief Prints a setting as `key value...`
+ * @param key commandKey() of the setting
+ * @return false for an unknown key (nothing printed)
+ */
+bool printSetting(uint16_t key) {
+  switch (key) {
+  case commandKey('i', 'v'):
+    Serial.print(F("iv "));
+    Serial.print(waterInterval);
+    break;
+  case commandKey('d', 'm'):
+    Serial.print(F("dm "));
+    Serial.print(waterDuration);
+    break;
+  case commandKey('d', 'c'):
+    Serial.print(F("dc "));
+    Serial.print(waterVolumeMl * 10UL / millilitresPerCup);
+    break;
+  case commandKey('t', 'h'):
+    Serial.print(F("th "));
+    Serial.print(plant.wetPercent);
+    break;
+  case commandKey('w', 'd'):
+    Serial.print(F("wd "));
+    Serial.print(waterDetectThreshold);
+    break;
+  case commandKey('c', 'a'):
+    Serial.print(F("ca "));
+    Serial.print(oneCupCalibrated);
+    break;
+  case commandKey('a', 'm'):
+    Serial.print(F("am "));
+    Serial.print(isAutoModeEnabled ? 1 : 0);
+    break;
+  case commandKey('r', 't'): {
+    RtcDateTime now = rtc.GetDateTime();
+    RECORD_RTC(now.TotalSeconds());
+    char buffer[32];
+    sprintf(buffer, "rt %u %u %u %u %u %u", now.Year(), now.Month(), now.Day(),
+            now.Hour(), now.Minute(), now.Second());
+    Serial.print(buffer);
+    break;
+  }
+  case commandKey('v', 'm'):
+    Serial.print(F("vm "));
+    Serial.print(waterVolumeMl);
+    break;
+  case commandKey('c', 't'):
+  case commandKey('c', 'f'): {
+    PumpCurveKind kind =
+        key == commandKey('c', 't') ? PUMP_CURVE_TIME : PUMP_CURVE_FLOW;
+    Serial.print(kind == PUMP_CURVE_TIME ? F("ct") : F("cf"));
+    for (uint8_t i = 0; i < pumpCurveSize(kind); ++i) {
+      PumpCurvePoint point = pumpCurvePoint(kind, i);
+      Serial.print(' ');
+      Serial.print(point.x);
+      Serial.print(' ');
+      Serial.print(point.y);
+    }
+    break;
+  }
+  case commandKey('t', 'k'):
+    Serial.print(F("tk "));
+    Serial.print(tankRemainingMl());
+    Serial.print(' ');
+    Serial.print(tankHoursToLow(dailyWaterUseMl()));
+    break;
+  case commandKey('l', 'm'):
+    Serial.print(F("lm "));
+    Serial.print(lcd.isMirroring() ? 1 : 0);
+    break;
+  case commandKey('p', 'p'):
+    Serial.print(F("pp "));
+    Serial.print(plant.index);
+    break;
+  case commandKey('w', 'n'): {
+    Serial.print(F("wn"));
+    uint32_t hours = windowHours();
+    for (uint8_t hour = 0; hour < 24; ++hour) {
+      bool open = (hours >> hour) & 1;
+      bool wasOpen = hour > 0 && ((hours >> (hour - 1)) & 1);
+      if (open != wasOpen) {
+        Serial.print(' ');
+        Serial.print(hour);
+      }
     }
+    if ((hours >> 23) & 1) {
+      Serial.print(F(" 24"));
+    }
+    break;
+  }
+  case commandKey('w', 'b'):
+    Serial.print(F("wb "));
+    Serial.print(windowBatchMinutes());
+    break;
+  default:
+    return false;
+  }
+  commandEndReply();
+  return true;
+}
 
-    // Handle increment/decrement buttons
-    int direction = 0;
-    if (isButtonPressed(buttonPins[minus]))
-      direction = -1; // Decrement
-    if (isButtonPressed(buttonPins[plus]))
-      direction = 1; // Increment
+/**
+ * @brief Applies an `s` command after range-checking its arguments
+ * @param command Decoded line
+ * @return false for an unknown key, wrong argument count or out-of-range value
+ */
+bool applySetting(const SerialCommand &command) {
+  if (command.argc == 0) {
+    return false;
+  }
+  long value = command.argv[0];
 
-    if (direction != 0) {
-      switch (step) {
-      case SET_YEAR:
-        year = constrain(year + direction, 2000, 2099);
-        break;
-      case SET_MONTH:
-        month = constrain(month + direction, 1, 12);
-        break;
-      case SET_DAY:
-        day = constrain(day + direction, 1, 31);
-        break;
-      case SET_HOUR:
-        hour = constrain(hour + direction, 0, 23);
-        break;
-      case SET_MINUTE:
-        minute = constrain(minute + direction, 0, 59);
-        break;
-      case DONE:
-        break;
+  switch (command.key) {
+  case commandKey('i', 'v'):
+    if (command.argc != 1 || value < plant.minSpacingMin ||
+        value > plantMaxIntervalMin) {
+      return false;
+    }
+    waterInterval = value;
+    waterIntervalHour = value;
+    return true;
+  case commandKey('d', 'm'):
+    if (command.argc != 1 || value < 100 || value > 600000L) {
+      return false;
+    }
+    waterDuration = value;
+    waterVolumeMl = 0;
+    autoWaterDurationMillis = value;
+    return true;
+  case commandKey('d', 'c'):
+    if (command.argc != 1 || !hasDoseCalibration() || value < 5 ||
+        value > doseRange.maxValue) {
+      return false;
+    }
+    setDoseMillilitres(value * millilitresPerCup / 10);
+    autoWaterDurationMillis = waterDuration;
+    return true;
+  case commandKey('t', 'h'):
+    if (command.argc != 1 || value < 1 || value > 100) {
+      return false;
+    }
+    plantSetWetPercent(value);
+    return true;
+  case commandKey('w', 'd'):
+    if (command.argc != 1 || value < 0 || value > 1023) {
+      return false;
+    }
+    waterDetectThreshold = value;
+    return true;
+  case commandKey('c', 'a'):
+    if (command.argc != 1 || value < 1000 || value > 600000L) {
+      return false;
+    }
+    oneCupCalibrated = value;
+    return true;
+  case commandKey('a', 'm'):
+    if (command.argc != 1 || value < 0 || value > 1 ||
+        (value == 1 && waterInterval == 0)) {
+      return false;
+    }
+    if (value == 1 && !isAutoModeEnabled) {
+      autoTimer = millis();
+      windowCancel();
+      heatRemainder.durationMs = 0;
+    }
+    isAutoModeEnabled = value == 1;
+    return true;
+  case commandKey('r', 't'):
+    if (command.argc != 6 || value < 2000 || value > 2099 ||
+        command.argv[1] < 1 || command.argv[1] > 12 || command.argv[2] < 1 ||
+        command.argv[2] > 31 || command.argv[3] < 0 || command.argv[3] > 23 ||
+        command.argv[4] < 0 || command.argv[4] > 59 || command.argv[5] < 0 ||
+        command.argv[5] > 59) {
+      return false;
+    }
+    rtc.SetDateTime(RtcDateTime(value, command.argv[1], command.argv[2],
+                                command.argv[3], command.argv[4],
+                                command.argv[5]));
+    return true;
+  case commandKey('v', 'm'):
+    if (command.argc != 1 || value < 0 || value > plant.maxDoseMl ||
+        (value > 0 && !hasDoseCalibration())) {
+      return false;
+    }
+    if (value == 0) {
+      waterVolumeMl = 0;
+    } else {
+      setDoseMillilitres(value);
+      autoWaterDurationMillis = waterDuration;
+    }
+    return true;
+  case commandKey('c', 't'):
+  case commandKey('c', 'f'): {
+    // `s ct 0` clears the curve, `s ct x y` adds a point
+    PumpCurveKind kind = command.key == commandKey('c', 't') ? PUMP_CURVE_TIME
+                                                             : PUMP_CURVE_FLOW;
+    if (command.argc == 1 && value == 0) {
+      pumpCurveClear(kind);
+      return true;
+    }
+    if (command.argc != 2 || value <= 0 || command.argv[1] <= 0 ||
+        command.argv[1] > 65535L ||
+        !pumpCurveAdd(kind, value, command.argv[1])) {
+      return false;
+    }
+    if (kind == PUMP_CURVE_TIME) {
+      oneCupCalibrated = pumpCurveDuration(millilitresPerCup);
+    }
+    return true;
+  }
+  case commandKey('t', 'k'):
+    if (command.argc != 1 || value < 0 || value > Hw::tankCapacityMl) {
+      return false;
+    }
+    tankSetRemaining(value);
+    return true;
+  case commandKey('l', 'm'):
+    if (command.argc != 1 || value < 0 || value > 1) {
+      return false;
+    }
+    lcd.setMirror(value == 1);
+    return true;
+  case commandKey('p', 'p'):
+    if (command.argc != 1 || value < 0 || value >= plantProfileCount) {
+      return false;
+    }
+    plantChoice = value;
+    applyPlantProfile();
+    return true;
+  case commandKey('w', 'n'): {
+    if (command.argc < 2 || command.argc % 2 != 0) {
+      return false;
+    }
+    uint32_t hours = 0;
+    for (uint8_t i = 0; i < command.argc; i += 2) {
+      long start = command.argv[i];
+      long end = command.argv[i + 1];
+      if (start < 0 || start > 23 || end < 1 || end > 24 || start == end) {
+        return false;
       }
-      buttonHandled = true;
-      lastStep = DONE; // Force display update
+      hours |= start < end ? plantHours(start, end)
+                           : plantHours(start, 24) | plantHours(0, end);
     }
+    windowSetHours(hours);
+    return true;
+  }
+  case commandKey('w', 'b'):
+    if (command.argc != 1 || value < 0 || value > 240) {
+      return false;
+    }
+    windowSetBatchMinutes(value);
+    return true;
+  default:
+    return false;
+  }
+}
 
-    if (buttonHandled) {
-      delay(inputDebounceDelay);
-    } else {
-      delay(10); // Small delay when no button pressed
+/**
+ * @brief Prints the event log over Serial, oldest first
+ * @details One `ev YYYY-MM-DD HH:MM description` line per event, then the
+ * number of events. A full log is about 3 KB, ~3 s at 9600 baud, well inside
+ * the watchdog period.
+ */
+void printEventLog() {
+  char text[17];
+  uint8_t count = eventLogCount();
+  for (uint8_t age = count; age-- > 0;) {
+    EventRecord record;
+    eventLogGet(age, record);
+    Serial.print(F("ev "));
+    eventLogFormatTime(record, text, sizeof(text));
+    Serial.print(text);
+    Serial.print(' ');
+    eventLogDescribe(record, text, sizeof(text));
+    Serial.println(text);
+  }
+  Serial.print(count);
+  Serial.print(F(" events"));
+  commandEndReply();
+}
+
+#ifdef FAULT_INJECTION
+/**
+ * @brief Drives one supervisor fault path on purpose (bench testing)
+ * @param fault SupervisorFault to provoke:
+ * - 1 (watchdog): pump on, then stop servicing; the watchdog must stop it
+ * - 2 (pump runtime): start the pump and leave it for the runtime cap
+ * - 3 (pump dry): start the pump and make the tank read low
+ * @return false for a fault that cannot be injected (nothing done)
+ * @details Answers `OK` before acting.
+ */
+bool injectFault(long fault) {
+  if (fault < FAULT_WATCHDOG || fault > FAULT_PUMP_DRY) {
+    return false;
+  }
+  Serial.print(F("OK"));
+  commandEndReply();
+
+  pumpStart(false, PUMP_REASON_REMOTE, Hw::pumpHighSetting);
+  if (fault == FAULT_WATCHDOG) {
+#if defined(__AVR__)
+    Serial.flush();
+    while (true) {
     }
+#else
+    supervisorWatchdogExpired(); // host: no watchdog, run its handler
+    handleFault(FAULT_WATCHDOG);
+#endif
+  }
+  injectedDryTank = fault == FAULT_PUMP_DRY;
+  return true;
+}
+#endif
+
+/**
+ * @brief Interactive settings configuration menu
+ * @details Lists the settingsList entries: (-)/(+) browse, (M) opens one,
+ * (A) exits to the main menu.
+ */
+void settingsMenu() {
+  if (showInstructions) {
+    printInstructions();
+  }
+
+  menuOpen(settingsList, "Select Option:");
+  if (runMenu() == MENU_CANCELLED) {
+    printExitCurrentMenu();
   }
+}
 
-  RtcDateTime newTime(year, month, day, hour, minute, 0);
+/**
+ * @brief Sets the date and time on the RTC module
+ * @details Walks dateTimeForm (year, month, day, hour, minute), starting
+ * from the RTC's current time, and saves to the RTC once the minute is
+ * confirmed
+ */
+void setDateTime() {
+  RtcDateTime now = rtc.GetDateTime();
+  dateTimeValues[0] = constrain(now.Year(), 2000, 2099);
+  dateTimeValues[1] = now.Month();
+  dateTimeValues[2] = now.Day();
+  dateTimeValues[3] = now.Hour();
+  dateTimeValues[4] = now.Minute();
+
+  menuOpen(dateTimeForm);
+  if (runMenu() == MENU_CANCELLED) {
+    printExitCurrentMenu();
+    return;
+  }
+
+  RtcDateTime newTime(dateTimeValues[0], dateTimeValues[1], dateTimeValues[2],
+                      dateTimeValues[3], dateTimeValues[4], 0);
   rtc.SetDateTime(newTime);
+  animationToast("Time Set!", "", exitDelay);
+}
 
-  lcd.clear();
-  printMessage(0, 0, "Time Set!");
-  delay(exitDelay);
+/**
+ * @brief Picks the plant profile from the library
+ * @details (-)/(+) browse the profile names, (M) makes the one shown active
+ * (see PlantProfile.h), (A) keeps the current one.
+ */
+void choosePlantProfile() {
+  plantChoice = plant.index;
+  menuOpen(plantForm);
+  if (runMenu() == MENU_CANCELLED) {
+    printExitCurrentMenu();
+    return;
+  }
+  animationToast("Profile set!", plantName(plant.index), exitDelay);
 }
 
 /**
- * @brief Calibrates pump timing for accurate water dispensing
- * @details Interactive calibration process to determine timing for 1 cup of
- * water:
- * - User sets test duration
- * - System runs pump for specified time
- * - User confirms if output equals 1 cup
- * - Saves calibration value for automatic watering calculations
+ * @brief Builds the pump calibration curve from test runs
+ * @details Interactive calibration, repeated for as many points as wanted:
+ * - User sets test duration and pump speed
+ * - System runs pump for specified time at that speed
+ * - Output is read from the flow meter, or the user enters the measured
+ *   volume (defaults to about one cup)
+ * - Full-speed runs add a (time, volume) point, every run a (speed, flow)
+ *   point; the one-cup time is derived from the curve
+ * - A run stopped early (abort, safety stop, pump heat) saves no point
  */
 void waterCalibrationTest() {
   if (!isWaterDetected()) {
-    printMessage(0, 0, "No water in tank!");
-    printMessage(0, 1, "Please add water!");
-    delay(5000);
+    animationToast("No water in tank!", "Please add water!", 5000);
     return;
   }
 
-  unsigned long waterTestDuration = 30000UL;
-  bool testReady = false;
+  calibrationSeconds = 30;
+  calibrationSpeed = 100;
   printMessage(0, 0, "Remove hose from");
   printMessage(0, 1, "Pot (+)=Continue");
-  while (!isButtonPressed(buttonPins[plus]))
-    ;
+  while (!isButtonPressed(buttonPins[plus])) {
+    if (isButtonPressed(buttonPins[aye])) { // (A) or the screen deadline
+      printExitCurrentMenu();
+      return;
+    }
+    serviceNap();
+  }
   delay(inputDebounceDelay);
 
   while (true) {
-    if (!testReady) {
-      // Set duration
-      lcd.clear();
-      printMessage(0, 0, "Water Duration");
-      printMessage(0, 1, "(sec): " + String(waterTestDuration / 1000));
-
-      while (true) {
-        if (isButtonPressed(buttonPins[minus]) && waterTestDuration > 1000) {
-          waterTestDuration -= 1000;
-          continue;
-        }
-        if (isButtonPressed(buttonPins[plus])) {
-          waterTestDuration += 1000;
-          continue;
-        }
-        if (isButtonPressed(buttonPins[em])) {
-          testReady = true;
-          continue;
-        }
-        if (isButtonPressed(buttonPins[aye])) {
-          printExitCurrentMenu();
-          return;
-        }
-      }
-      delay(200);
-      continue;
+    menuOpen(calibrationForm);
+    if (runMenu() == MENU_CANCELLED) {
+      printExitCurrentMenu();
+      return;
     }
 
     // Ask to start test
     lcd.clear();
     printMessage(0, 0, "Start Cal Test?");
     printMessage(0, 1, "(-)=No (+)=Yes");
+    while (!isButtonPressed(buttonPins[plus])) {
+      if (isButtonPressed(buttonPins[minus]) ||
+          isButtonPressed(buttonPins[aye])) {
+        printExitCurrentMenu();
+        return;
+      }
+      serviceNap();
+    }
 
-    while (true) {
-      if (isButtonPressed(buttonPins[minus])) {
+    // Dispense water
+    unsigned long durationMs = calibrationSeconds * 1000UL;
+    uint8_t pwm = calibrationSpeed * Hw::pumpHighSetting / 100;
+    if (pumpHeatHeadroomMs(pwm) < durationMs) {
+      animationToast("Pump too hot!", "Wait or run less", transitionDelay);
+      waitForAnimation();
+      return;
+    }
+    lcd.clear();
+    printMessage(0, 0, "Dispensing..");
+    printMessage(0, 1, "Please Wait!");
+    pumpStart(true, PUMP_REASON_CALIBRATION, pwm);
+    PumpRunResult result = runPump(durationMs, 0);
+    long volumeMl = Hw::hasFlowMeter
+                        ? flowPulsesToMillilitres(flowPulses() - pumpStartPulses)
+                        : millilitresPerCup;
+    pumpStop(true);
+
+    // A point is only worth keeping if the pump ran the full time
+    if (result != PUMP_RUN_DONE) {
+      animationToast("Run cut short", "Point not saved", transitionDelay);
+      waitForAnimation();
+      return;
+    }
+    animationToast("Done!", "", exitDelay);
+    waitForAnimation();
+
+    if (!Hw::hasFlowMeter) {
+      calibrationVolume = volumeMl;
+      menuOpen(calibrationVolumeForm);
+      if (runMenu() == MENU_CANCELLED) {
         printExitCurrentMenu();
         return;
       }
-      if (isButtonPressed(buttonPins[plus])) {
-        // Dispense water
-        lcd.clear();
-        printMessage(0, 0, "Dispensing..");
-        printMessage(0, 1, "Please Wait!");
-        digitalWrite(pumpValvePin, HIGH);
-        delay(pumpValveTiming);
-        analogWrite(pumpPin, pumpHighSetting);
-        delay(waterTestDuration);
-        analogWrite(pumpPin, 0);
-        delay(pumpValveTiming);
-        digitalWrite(pumpValvePin, LOW);
+      volumeMl = calibrationVolume;
+    }
 
-        lcd.clear();
-        printMessage(0, 0, "Done!");
-        delay(exitDelay);
+    // Points are uint16_t; 0 ml (e.g. a dry flow meter) is rejected below
+    volumeMl = constrain(volumeMl, 0L, 0xFFFFL);
+    unsigned long flow = min(volumeMl * 60000UL / durationMs, 0xFFFFUL);
+    bool saved = true;
+    if (pwm == Hw::pumpHighSetting) {
+      saved = pumpCurveAdd(PUMP_CURVE_TIME, durationMs, volumeMl);
+      oneCupCalibrated = pumpCurveDuration(millilitresPerCup);
+    }
+    if (!pumpCurveAdd(PUMP_CURVE_FLOW, pwm, flow)) {
+      saved = false;
+    }
 
-        // Check if output was 1 cup
-        lcd.clear();
-        printMessage(0, 0, "1 cup output?");
-        printMessage(0, 1, "(-)=No (+)=Yes");
-
-        while (true) {
-          if (isButtonPressed(buttonPins[minus])) {
-            testReady = false; // Retry - go back to duration setting
-            break;
-          }
-          if (isButtonPressed(buttonPins[plus])) {
-            // Save calibration and exit
-            oneCupCalibrated = waterTestDuration;
-            lcd.clear();
-            printMessage(0, 0, "1Cup Calibration");
-            delay(500);
-            printMessage(4, 1, "Saved!");
-            delay(2000);
-            return;
-          }
-          if (isButtonPressed(buttonPins[aye])) {
-            printExitCurrentMenu();
-            return;
-          }
-        }
+    lcd.clear();
+    printMessage(0, 0, saved ? "Point Saved!" : "Point rejected!");
+    printMessage(0, 1, "(+)More (-)Done");
+    while (true) {
+      if (isButtonPressed(buttonPins[plus])) {
         break;
       }
-      if (isButtonPressed(buttonPins[aye])) {
+      if (isButtonPressed(buttonPins[minus]) ||
+          isButtonPressed(buttonPins[aye])) {
         printExitCurrentMenu();
         return;
       }
+      serviceNap();
+    }
+  }
+}
+
+/**
+ * @brief Diagnostic pages for stack and heap usage
+ * @details Two pages, switched with (-)/(+) and refreshed every second:
+ * - Stack high-water mark since reset and the current free gap
+ * - Heap size, free-list bytes/blocks and fragmentation
+ * Button A exits.
+ */
+void showDiagnostics() {
+  unsigned char page = 0;
+  unsigned long lastRefresh = 0;
+  bool redraw = true;
+
+  while (true) {
+    if (redraw || millis() - lastRefresh >= 1000) {
+      MemoryStats stats;
+      memoryStats(stats);
+      char line[17];
+
+      lcd.clear();
+      if (page == 0) {
+        snprintf(line, sizeof(line), "Stack pk: %5uB", stats.stackPeak);
+        printMessage(0, 0, line);
+        snprintf(line, sizeof(line), "Free now: %5uB", stats.freeNow);
+        printMessage(0, 1, line);
+      } else {
+        snprintf(line, sizeof(line), "Heap:     %5uB", stats.heapSize);
+        printMessage(0, 0, line);
+        snprintf(line, sizeof(line), "Frag:%3u%% %3ubl",
+                 memoryFragmentation(stats), stats.heapBlocks);
+        printMessage(0, 1, line);
+      }
+      lastRefresh = millis();
+      redraw = false;
+    }
+
+    if (isButtonPressed(buttonPins[minus]) ||
+        isButtonPressed(buttonPins[plus])) {
+      page ^= 1;
+      redraw = true;
+    }
+    if (isButtonPressed(buttonPins[aye])) {
+      printExitCurrentMenu();
+      return;
+    }
+    serviceNap();
+  }
+}
+
+/**
+ * @brief Browses the event log on the LCD, newest first
+ * @details Top row: when, and the entry's position (1 = newest); bottom row:
+ * what happened. (-) steps back in time, (+) forward, (M) or (A) exits.
+ */
+void showEventLog() {
+  uint8_t age = 0;
+  bool redraw = true;
+
+  while (true) {
+    if (redraw) {
+      lcd.clear();
+      EventRecord record;
+      if (eventLogGet(age, record)) {
+        char text[17];
+        eventLogFormatTime(record, text, sizeof(text));
+        printMessage(0, 0, text + 5); // MM-DD HH:MM
+        printMessage(12, 0, String(age + 1));
+        eventLogDescribe(record, text, sizeof(text));
+        printMessage(0, 1, text);
+      } else {
+        printMessage(0, 0, "Event Log");
+        printMessage(0, 1, "(empty)");
+      }
+      redraw = false;
+    }
+
+    if (isButtonPressed(buttonPins[minus]) && age + 1 < eventLogCount()) {
+      ++age;
+      redraw = true;
+    }
+    if (isButtonPressed(buttonPins[plus]) && age > 0) {
+      --age;
+      redraw = true;
+    }
+    if (isButtonPressed(buttonPins[em]) || isButtonPressed(buttonPins[aye])) {
+      printExitCurrentMenu();
+      return;
     }
+    serviceNap();
   }
 }
 
@@ -1000,11 +2189,8 @@ void disableMessages() {
       delay(inputDebounceDelay);
       if (isButtonPressed(buttonPins[minus])) {
         showInstructions = false;
-        lcd.clear();
-        printMessage(2, 0, "Tip messages:");
-        delay(500);
-        printMessage(2, 1, "Disabled");
-        delay(1000);
+        animationQueue("Tip messages:", 2, 0, 500, ANIMATE_CLEAR);
+        animationQueue("Disabled", 2, 1, 1000);
         return;
       }
     }
@@ -1013,45 +2199,22 @@ void disableMessages() {
       if (isButtonPressed(buttonPins[plus])) {
         showInstructions = true;
         printInstructions();
-        printMessage(0, 0, "M: Confirm/Next");
-        printMessage(0, 1, "A: Cancel");
-        delay(transitionDelay);
+        animationToast("M: Confirm/Next", "A: Cancel", transitionDelay);
         return;
       }
     }
+    serviceNap();
   }
 }
 
 /**
- * @brief Reads soil moisture sensor with caching optimization
+ * @brief Soil moisture no older than a second
  * @return Soil moisture percentage as float (0.0-100.0)
- * @details Implements smart caching to reduce sensor reads and improve
- * performance:
- * - Caches readings for 5 seconds to avoid excessive ADC calls
- * - Converts analog reading (0-1023) to moisture percentage
- * - Higher analog values indicate drier soil (inverted scale)
- * - Returns cached value if called within caching window
- */
-float readSoilMoisture() {
-  static unsigned long lastReading = 0;
-  static float lastMoisture = 0;
-  unsigned long now = millis();
-
-  // Cache reading for 1 second to avoid unnecessary sensor reads
-  if (now - lastReading < 1000) {
-    return lastMoisture;
-  }
-
-  digitalWrite(pinSoilPower, HIGH);
-  delay(10); // Small delay for sensor stabilization
-  lastRawMoistureValue = analogRead(pinSoilRead);
-  digitalWrite(pinSoilPower, LOW);
-
-  lastMoisture = calculateMoisture(lastRawMoistureValue);
-  lastReading = now;
-
-  return lastMoisture;
-}
+ * @details Uses the background sample when it is recent enough (it is,
+ * during and just after watering), otherwise reads the probe now. Higher
+ * analog values indicate wetter soil.
+ */
+float readSoilMoisture() { return calculateMoisture(soilRead(1000).raw); }
 
 /**
  * @brief Converts raw ADC reading to moisture percentage
@@ -1060,12 +2223,12 @@ float readSoilMoisture() {
  * @details Maps sensor reading between dry and wet calibration values
  */
 unsigned char calculateMoisture(unsigned int raw) {
-  if (raw <= DRY_VALUE)
+  if (raw <= Hw::dryValue)
     return 0;
-  if (raw >= WET_VALUE)
+  if (raw >= Hw::wetValue)
     return 100;
 
-  return map(raw, DRY_VALUE, WET_VALUE, 0, 100);
+  return map(raw, Hw::dryValue, Hw::wetValue, 0, 100);
 }
 
 /**
@@ -1073,44 +2236,153 @@ unsigned char calculateMoisture(unsigned int raw) {
  * @return true if water level is low, false if adequate
  * @details Simple digital read from water level sensor pin
  */
-bool isWaterDetected() { return digitalRead(waterSensorPin) != HIGH; }
+bool isWaterDetected() {
+  if (!Hw::hasFloatSwitch) {
+    return true;
+  }
+  bool level = WaterLevelSwitch::read();
+  RECORD_PIN(Hw::floatSwitch, level);
+  return !level;
+}
 
 /**
  * @brief Comprehensive safety check before watering
  * @return true if safe to water, false if conditions prevent watering
  * @details Checks multiple safety conditions:
+ * - Tank level (prevents dry pumping)
  * - Soil moisture level (prevents overwatering)
  * - Water detection sensor (prevents flooding)
- * - Displays appropriate warning messages
+ * - Queues a warning toast (without waiting for it) and keeps the reason in
+ *   lastWaterBlock
  */
 bool isPlantOkayToWater() {
-  digitalWrite(waterDetectionPower, HIGH);
-  delay(sensorWarmTime);
-  unsigned int waterDetectionValue = analogRead(waterDetectionRead);
+  PROFILE_SCOPE(PROFILE_PROBE);
+  if (!isWaterDetected()) {
+    lastWaterBlock = EVENT_SKIP_TANK;
+    animationToast("Water Lvl Low!", "Please add water", 3000);
+    return false;
+  }
 
-  moistureLevel = readSoilMoisture();
-  if (moistureLevel >= 70) {
-    lcd.clear();
-    printMessage(0, 0, "Soil already wet!");
-    printMessage(0, 1, getMoistureValue());
-    delay(3000);
-    lcd.clear();
+  unsigned int waterDetectionValue = 0;
+  if (Hw::hasWaterDetectProbe) {
+    WaterDetectPower::high();
+    delay(sensorWarmTime);
+    waterDetectionValue = analogRead(Hw::waterDetectRead);
+    RECORD_ANALOG(Hw::waterDetectRead, waterDetectionValue);
+    WaterDetectPower::low();
+    lastWaterDetectValue = waterDetectionValue;
+  }
+
+  SoilSample soil = soilRead(1000);
+  moistureLevel = calculateMoisture(soil.raw);
+  if (soil.raw >= plant.wetRaw) {
+    lastWaterBlock = EVENT_SKIP_WET;
+    static char reading[5]; // outlives the toast
+    strcpy(reading, getMoistureValue().c_str());
+    animationToast("Soil already wet!", reading, 3000);
     return false;
   }
 
-  if (waterDetectionValue > waterDetectThreshold) {
-    lcd.clear();
-    printMessage(0, 0, "WATER DETECTED!!");
-    printMessage(0, 1, "TRY AGAIN LATER");
-    delay(3000);
-    lcd.clear();
+  if (Hw::hasWaterDetectProbe &&
+      waterDetectionValue > waterDetectThreshold) {
+    lastWaterBlock = EVENT_SKIP_SPILL;
+    animationToast("WATER DETECTED!!", "TRY AGAIN LATER", 3000);
     return false;
   }
 
-  digitalWrite(waterDetectionPower, LOW);
   return true;
 }
 
+/**
+ * @brief Opens the valve (when fitted) and starts the pump
+ * @param settleValve Wait for the valve to open before starting the pump
+ * @param reason TelemetryPumpReason reported with the pump record
+ * @param pwm Pump duty (Hw::pumpHighSetting for full speed)
+ * @details Clears any earlier abort request; one arriving (`x`) while the
+ * valve settles is kept for runPump(), which then ends the run at once.
+ */
+void pumpStart(bool settleValve, uint8_t reason, uint8_t pwm) {
+  wateringAbortRequested = false;
+  if (Hw::hasValve) {
+    PumpValve::high();
+    if (settleValve) {
+      pumpStarting = true;
+      serviceDelay(Hw::pumpValveTiming);
+      pumpStarting = false;
+    }
+  }
+  pumpDriveSet(pwm);
+  pumpStarted(reason, pwm, millis());
+}
+
+/**
+ * @brief Records a pump start the hardware has already made
+ * @param reason TelemetryPumpReason reported with the pump record
+ * @param pwm Pump duty
+ * @param startedAt millis() when the pump came on
+ * @details Split from pumpStart() for manual mode, where the button interrupt
+ * switches the pump (ManualPump.h).
+ */
+void pumpStarted(uint8_t reason, uint8_t pwm, unsigned long startedAt) {
+  supervisorPumpChanged(true);
+  soilWatering(true);
+
+  isPumpRunning = true;
+  pumpStartedAt = startedAt;
+  pumpReason = reason;
+  pumpPwm = pwm;
+  if (Hw::hasFlowMeter) {
+    pumpStartPulses = flowPulses();
+  }
+
+  TelemetryPump record;
+  telemetryHeader(record.header, TELEMETRY_PUMP);
+  record.on = 1;
+  record.reason = reason;
+  record.runtimeMs = 0;
+  record.volumeMl = 0;
+  telemetrySend(&record, sizeof(record));
+}
+
+/**
+ * @brief Stops the pump and closes the valve (when fitted)
+ * @param settleValve Let the line drain before closing the valve
+ */
+void pumpStop(bool settleValve) {
+  pumpDriveStop();
+  pumpStopped(millis());
+  if (Hw::hasValve) {
+    if (settleValve) {
+      serviceDelay(Hw::pumpValveTiming);
+    }
+    PumpValve::low();
+  }
+}
+
+/**
+ * @brief Records a pump stop the hardware has already made
+ * @param stoppedAt millis() when the pump went off
+ */
+void pumpStopped(unsigned long stoppedAt) {
+  supervisorPumpChanged(false);
+  soilWatering(false);
+  if (isPumpRunning) {
+    isPumpRunning = false;
+
+    TelemetryPump record;
+    telemetryHeader(record.header, TELEMETRY_PUMP);
+    record.on = 0;
+    record.reason = pumpReason;
+    record.runtimeMs = stoppedAt - pumpStartedAt;
+    record.volumeMl =
+        Hw::hasFlowMeter ? flowPulsesToMillilitres(flowPulses() - pumpStartPulses)
+                         : estimateVolumeMl(pumpPwm, record.runtimeMs);
+    tankDispensed(record.volumeMl);
+    telemetrySend(&record, sizeof(record));
+    eventLogAdd(EVENT_WATERED, pumpReason, record.volumeMl);
+  }
+}
+
 /**
  * @brief Display message at specific LCD coordinates
  * @param x Column position (0-15 for 16x2 LCD)
@@ -1126,33 +2398,75 @@ void printMessage(int x, int y, const String &message) {
 
 /**
  * @brief Animated text display with typewriter effect
- * @param message Text to display with animation
- * @details Creates a typewriter effect by printing characters one by one
- * with a 100ms delay between each character. Uses blinking cursor for
- * visual feedback and positions text on the second row of LCD
+ * @param message Text to display with animation; must outlive it (a literal)
+ * @details Queues a typewriter effect on the second row: one character every
+ * bootAnimationDelay ms behind a blinking cursor. Returns at once.
  */
-void printAnimation(String message) {
-  lcd.setCursor(0, 1);
-  lcd.blink();
-  for (unsigned int i = 0; i < message.length(); ++i) {
-    lcd.print(message.charAt(i));
-    delay(bootAnimationDelay);
-  }
-  lcd.noBlink();
+void printAnimation(const char *message) {
+  animationQueue(message, 0, 1, bootAnimationDelay, ANIMATE_TYPE);
 }
 
 /**
  * @brief Displays standard exit message when leaving menus
- * @details Shows a friendly "Please Wait" message followed by "Exiting"
- * with appropriate delays for user feedback. Provides consistent
- * exit experience across all menu functions
+ * @details Queues a friendly "Please Wait" message followed by "Exiting" and
+ * returns at once; the main menu comes back when it finishes or a button
+ * skips it. Provides consistent exit experience across all menu functions
  */
 void printExitCurrentMenu() {
-  lcd.clear();
-  printMessage(0, 0, "Please Wait ^_^ ");
-  delay(200);
-  printMessage(4, 1, "Exiting");
-  delay(exitDelay);
+  animationQueue("Please Wait ^_^ ", 0, 0, 200, ANIMATE_CLEAR);
+  animationQueue("Exiting", 4, 1, exitDelay);
+}
+
+/**
+ * @brief Reads the buttons as a menu key
+ * @param held Set while the (-)/(+) button last returned is still down
+ * @return The newly pressed key, MENU_KEY_NONE if none
+ * @details (M) and (A) wait for their release; (-)/(+) return at once and
+ * report the hold on later calls, for the menu's hold-to-repeat.
+ */
+MenuKey readMenuKey(bool &held) {
+  static unsigned char heldButton = totalButtons; // none
+  if (heldButton < totalButtons) {
+    bool released = readPin(buttonPins[heldButton]);
+    RECORD_PIN(buttonPins[heldButton], released);
+    if (!released) {
+      held = true;
+      return MENU_KEY_NONE;
+    }
+    heldButton = totalButtons;
+  }
+  held = false;
+
+  for (unsigned char i = 0; i < totalButtons; ++i) {
+    if (isButtonPressed(buttonPins[i])) {
+      if (i == minus || i == plus) {
+        heldButton = i;
+        held = true;
+      } else {
+        waitForRelease(buttonPins[i]);
+      }
+      return static_cast<MenuKey>(MENU_KEY_MINUS + i); // [-, +, M, A]
+    }
+  }
+  return MENU_KEY_NONE;
+}
+
+/**
+ * @brief Runs the open menu until it is confirmed or cancelled
+ * @return MENU_DONE or MENU_CANCELLED
+ * @details Polls the engine once per service nap, so the system keeps being
+ * serviced while the user edits.
+ */
+MenuResult runMenu() {
+  while (true) {
+    bool held;
+    MenuKey key = readMenuKey(held);
+    MenuResult result = menuPoll(key, held);
+    if (result != MENU_RUNNING) {
+      return result;
+    }
+    serviceNap();
+  }
 }
 
 /**
@@ -1160,19 +2474,39 @@ void printExitCurrentMenu() {
  * @details Shows standardized instruction text explaining button usage:
  * - How to use +/- buttons for value changes
  * - General navigation help for menu systems
- * Used across multiple menu functions for consistency
+ * Used across multiple menu functions for consistency. Waits (servicing) for
+ * both pages, or a button to skip them.
  */
 void printInstructions() {
-  lcd.clear();
-  printMessage(0, 0, "Use buttons to:");
-  printMessage(0, 1, "-/+ to change");
-  delay(transitionDelay);
+  animationToast("Use buttons to:", "-/+ to change", transitionDelay);
+  animationToast("M: Confirm/Next", "A: Exit", transitionDelay);
+  waitForAnimation();
+}
 
-  lcd.clear();
-  printMessage(0, 0, "M: Confirm/Next");
-  printMessage(0, 1, "A: Exit");
-  delay(transitionDelay);
-  lcd.clear();
+/**
+ * @brief Skips the running animation if any button is pressed
+ * @return true if a press was used up skipping
+ */
+bool skipAnimationOnPress() {
+  for (unsigned char i = 0; i < totalButtons; ++i) {
+    if (isButtonPressed(buttonPins[i])) {
+      waitForRelease(buttonPins[i]);
+      animationSkip();
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Services until queued animations finish; any button skips them
+ * @details For screens that draw once and must not be overdrawn.
+ */
+void waitForAnimation() {
+  while (animationActive()) {
+    skipAnimationOnPress();
+    serviceNap();
+  }
 }
 
 /**
@@ -1194,14 +2528,15 @@ void formatTime(int &hour, bool &isPM) {
 /**
  * @brief Formats soil moisture reading as percentage string
  * @return Formatted moisture string with proper spacing and % symbol
- * @details Converts the last raw moisture reading to a user-friendly format:
+ * @details Converts the latest background moisture sample (at most
+ * 15 min old) to a user-friendly format:
  * - Rounds to nearest whole percentage
  * - Constrains value to 0-100% range
  * - Provides consistent spacing (single-digit: "  5%", double: " 85%")
  * - Returns as String for easy LCD display
  */
 String getMoistureValue() {
-  unsigned char mP = calculateMoisture(lastRawMoistureValue);
+  unsigned char mP = calculateMoisture(soilLatest().raw);
 
   char buffer[5]; // " 99%\0"
   if (mP < 10) {
@@ -1215,14 +2550,33 @@ String getMoistureValue() {
   return String(buffer);
 }
 
+/**
+ * @brief Top row of the main menu
+ * @return The menu title, or a tank warning: low water, or a refill due
+ * within Hw::tankWarnHours at the scheduled rate
+ */
+String getMainMenuBanner() {
+  if (!isWaterDetected()) {
+    return "Water Lvl Low!  ";
+  }
+  uint16_t hours = tankHoursToLow(dailyWaterUseMl());
+  if (hours < Hw::tankWarnHours) {
+    char buffer[17]; // "Refill in 99h\0"
+    sprintf(buffer, "Refill in %uh", hours);
+    return String(buffer);
+  }
+  return "    MainMenu    ";
+}
+
 /**
  * @brief Formats countdown time for next watering
  * @param totalSecondsRemaining Total seconds until next watering
  * @param hoursPart Hours component of remaining time
  * @param minutesPart Minutes component of remaining time
- * @return Formatted time string (e.g., "2H30M" or "45 Sec")
+ * @return Formatted time string (e.g., "2H30M", " 5D04H" or "45 Sec")
  * @details Provides compact time display for LCD with different formats
- * based on time remaining (seconds vs hours/minutes)
+ * based on time remaining (seconds, hours/minutes, or days/hours from 100 h
+ * up, where hours and minutes would run past the 16th column)
  */
 String getNextFeed(const unsigned long totalSecondsRemaining,
                    const unsigned long hoursPart,
@@ -1234,7 +2588,11 @@ String getNextFeed(const unsigned long totalSecondsRemaining,
   }
 
   char buffer[8]; // " 99H99M\0"
-  if (hoursPart < 10) {
+  if (hoursPart >= 100) { // six columns left after "Feeds in: "
+    uint8_t days = min(hoursPart / 24, 99UL);
+    uint8_t hours = hoursPart % 24;
+    snprintf(buffer, sizeof(buffer), "%2uD%02uH", days, hours);
+  } else if (hoursPart < 10) {
     sprintf(buffer, " %luH%02luM", hoursPart, minutesPart);
   } else {
     sprintf(buffer, "%luH%02luM", hoursPart, minutesPart);
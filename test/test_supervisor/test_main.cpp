@@ -0,0 +1,126 @@
+/**
+ * @file test_main.cpp
+ * @brief Supervisor fault paths, run with: pio test -e native
+ * @author Quiyet Brul
+ * @date 2025
+ *
+ * @details Each test starts the pump through the firmware's own pumpStart()
+ * and services it with serviceTick(), the dispatcher every screen goes
+ * through, on the NativeArduino virtual clock. Whatever ends the run, the
+ * pump PWM must read 0 and the valve pin LOW afterwards.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "HardwareProfile.h"
+#include "Supervisor.h"
+#include "Telemetry.h"
+
+void setup();
+void serviceTick();
+void pumpStart(bool settleValve, uint8_t reason, uint8_t pwm);
+void pumpStop(bool settleValve);
+
+namespace {
+
+const unsigned long tickMs = 10; ///< Virtual time between service ticks
+
+void tankFull() { native::pinLevel[Hw::floatSwitch] = LOW; }
+
+void tankEmpty() { native::pinLevel[Hw::floatSwitch] = HIGH; }
+
+bool pumpRunning() { return native::pwmValue[Hw::pump] != 0; }
+
+/**
+ * @brief Services the firmware until the pump stops or ms have passed
+ * @return Milliseconds the pump ran on for
+ */
+unsigned long serviceUntilPumpOff(unsigned long ms) {
+  unsigned long start = millis();
+  while (pumpRunning() && millis() - start < ms) {
+    serviceTick();
+    delay(tickMs);
+  }
+  return millis() - start;
+}
+
+void assertSafeOutputs() {
+  TEST_ASSERT_EQUAL_UINT8(0, native::pwmValue[Hw::pump]);
+  TEST_ASSERT_EQUAL_UINT8(LOW, native::pinLevel[Hw::pumpValve]);
+}
+
+} // namespace
+
+void setUp() {
+  tankFull();
+  pumpStart(false, PUMP_REASON_MANUAL, Hw::pumpHighSetting);
+  serviceTick(); // ramps the duty up on the host
+  TEST_ASSERT_TRUE(pumpRunning());
+  TEST_ASSERT_EQUAL_UINT8(HIGH, native::pinLevel[Hw::pumpValve]);
+}
+
+void tearDown() {
+  pumpStop(false);
+  tankFull();
+}
+
+/**
+ * @brief A hang stops the dispatcher: the watchdog interrupt cuts the pump
+ * @details The host has no watchdog timer, so the test calls the interrupt
+ * handler's body directly, with the pump left running by the hung code.
+ */
+void test_watchdog_cuts_pump() {
+  supervisorWatchdogExpired();
+
+  assertSafeOutputs();
+  TEST_ASSERT_EQUAL(FAULT_WATCHDOG, supervisorLastFault());
+}
+
+void test_runtime_cap_cuts_pump() {
+  unsigned long ranMs = serviceUntilPumpOff(Hw::pumpMaxRuntimeMs + 1000UL);
+
+  assertSafeOutputs();
+  TEST_ASSERT_EQUAL(FAULT_PUMP_RUNTIME, supervisorLastFault());
+  TEST_ASSERT_UINT32_WITHIN(100UL, Hw::pumpMaxRuntimeMs, ranMs);
+}
+
+void test_tank_dry_during_run_cuts_pump() {
+  serviceUntilPumpOff(5000UL);
+  TEST_ASSERT_TRUE(pumpRunning());
+  tankEmpty();
+  serviceTick(); // the first tick that sees the float switch drop
+
+  assertSafeOutputs();
+  TEST_ASSERT_EQUAL(FAULT_PUMP_DRY, supervisorLastFault());
+}
+
+/**
+ * @brief A screen deadline only asks the screen to exit; it is not a fault
+ */
+void test_screen_timeout_is_not_a_fault() {
+  pumpStop(false);
+  uint8_t faults = supervisorFaultCount();
+  supervisorScreen(1);
+  unsigned long start = millis();
+  while (!supervisorExitRequested() && millis() - start < 2000UL) {
+    serviceTick();
+    delay(tickMs);
+  }
+
+  TEST_ASSERT_TRUE(supervisorExitRequested());
+  TEST_ASSERT_EQUAL_UINT8(faults, supervisorFaultCount());
+  supervisorLeaveScreen();
+}
+
+int main() {
+  tankFull();
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_watchdog_cuts_pump);
+  RUN_TEST(test_runtime_cap_cuts_pump);
+  RUN_TEST(test_tank_dry_during_run_cuts_pump);
+  RUN_TEST(test_screen_timeout_is_not_a_fault);
+  return UNITY_END();
+}
@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+"""Decode AutoWaterPump telemetry frames into CSV.
+
+The firmware sends COBS-framed records terminated by 0x00, each ending in a
+CRC-16/CCITT-FALSE (high byte first). Record layouts mirror include/Telemetry.h.
+
+Usage:
+    telemetry_decode.py capture.bin > telemetry.csv
+    cat /dev/ttyUSB0 | telemetry_decode.py - > telemetry.csv
+    telemetry_decode.py --trace inputs.trace capture.bin > telemetry.csv
+
+--trace also writes the input events of TELEMETRY_TRACE records (RECORDING
+builds, include/Recorder.h) as replay lines for env:native_replay:
+    <ms> pin <pin> <level> | <ms> adc <pin> <value> | <ms> rtc <offset>
+    <ms> serial <byte>
+A reboot in the capture (time going backwards) is marked with "# reset", and
+events the board dropped with "# lost <count> after <ms>".
+
+Frames that fail COBS decoding, the CRC check or have an unknown type are
+skipped and counted on stderr. Plain-text frames (command replies, which end
+in a 0x00 delimiter of their own) are echoed to stderr instead.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+HEADER = struct.Struct("<BBI")  # type, seq, time_ms
+
+# type -> (name, struct for the fields after the header, field names)
+RECORDS = {
+    1: (
+        "status",
+        struct.Struct("<HBHHBHIHHH"),
+        (
+            "moisture_raw",
+            "moisture_pct",
+            "moisture_age_s",
+            "water_detect_raw",
+            "flags",
+            "interval_min",
+            "seconds_to_watering",
+            "tank_ml",
+            "hours_to_low",
+            "dropped_frames",
+        ),
+    ),
+    2: (
+        "pump",
+        struct.Struct("<BBIH"),
+        ("pump_on", "reason", "runtime_ms", "volume_ml"),
+    ),
+    3: (
+        "lcd",
+        struct.Struct("<B16s"),
+        ("lcd_row", "lcd_text"),
+    ),
+    4: (
+        "fault",
+        struct.Struct("<BB"),
+        ("fault", "fault_count"),
+    ),
+}
+
+FLAGS = (
+    (0x01, "pump"),
+    (0x02, "valve"),
+    (0x04, "auto"),
+    (0x08, "tank_ok"),
+    (0x10, "backlight"),
+    (0x20, "deferred"),
+)
+
+TRACE = 5  # variable length: start_ms, then packed events
+TRACE_START = struct.Struct("<IH")  # start_ms, lost
+TRACE_KINDS = ("pin", "adc", "rtc", "serial")
+TRACE_PAYLOAD = {"adc": struct.Struct("<H"), "rtc": struct.Struct("<i")}
+
+COLUMNS = ["type", "seq", "time_ms"]
+for _, _, names in RECORDS.values():
+    COLUMNS.extend(n for n in names if n not in COLUMNS)
+COLUMNS.extend(("trace_events", "trace_lost"))
+COLUMNS.extend(name for _, name in FLAGS)
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(frame):
+    """Decode one COBS frame (without its 0x00 delimiter); None if malformed."""
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0:
+            return None
+        block = frame[i + 1 : i + code]
+        if len(block) != code - 1:
+            return None
+        out += block
+        i += code
+        if code < 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_trace(body):
+    """(lost, list of (ms, kind, pin, value) events) of a trace body, or None."""
+    if len(body) < TRACE_START.size:
+        return None
+    ms, lost = TRACE_START.unpack_from(body)
+    events = []
+    i = TRACE_START.size
+    while i < len(body):
+        tag = body[i]
+        i += 1
+        delta = shift = 0
+        while True:
+            if i >= len(body):
+                return None
+            byte = body[i]
+            i += 1
+            delta |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        ms = (ms + delta) & 0xFFFFFFFF
+        kind = TRACE_KINDS[tag >> 6]
+        pin = tag & 0x1F
+        if kind == "pin":
+            value = (tag >> 5) & 1
+        elif kind == "serial":
+            if i >= len(body):
+                return None
+            value = body[i]
+            i += 1
+        else:
+            payload = TRACE_PAYLOAD[kind]
+            if i + payload.size > len(body):
+                return None
+            (value,) = payload.unpack_from(body, i)
+            i += payload.size
+        events.append((ms, kind, pin, value))
+    return lost, events
+
+
+def decode_record(payload):
+    """Return a CSV row dict for a CRC-checked payload, or None."""
+    if len(payload) < HEADER.size:
+        return None
+    rtype, seq, time_ms = HEADER.unpack_from(payload)
+    if rtype == TRACE:
+        trace = decode_trace(payload[HEADER.size :])
+        if trace is None:
+            return None
+        lost, events = trace
+        return {
+            "type": "trace",
+            "seq": seq,
+            "time_ms": time_ms,
+            "trace_events": len(events),
+            "trace_lost": lost,
+            "events": events,
+        }
+    spec = RECORDS.get(rtype)
+    if spec is None or len(payload) != HEADER.size + spec[1].size:
+        return None
+    name, body, fields = spec
+    row = {"type": name, "seq": seq, "time_ms": time_ms}
+    row.update(zip(fields, body.unpack_from(payload, HEADER.size)))
+    if "lcd_text" in row:
+        row["lcd_text"] = row["lcd_text"].decode("ascii", "replace")
+    if "flags" in row:
+        for mask, flag in FLAGS:
+            row[flag] = int(bool(row["flags"] & mask))
+    return row
+
+
+def trace_line(event):
+    """One replay line for a decoded trace event."""
+    ms, kind, pin, value = event
+    if kind == "rtc":
+        return f"{ms} rtc {value}"
+    if kind == "serial":
+        return f"{ms} serial {value}"
+    return f"{ms} {kind} {pin} {value}"
+
+
+def is_text(frame):
+    """True for a printable ASCII line such as a command reply."""
+    return all(32 <= b < 127 or b in (9, 10, 13) for b in frame)
+
+
+def frames(stream, chunk_size=4096):
+    """Yield raw frames split on 0x00 from a binary stream."""
+    pending = bytearray()
+    while True:
+        chunk = stream.read(chunk_size)
+        if not chunk:
+            break
+        pending += chunk
+        *complete, rest = pending.split(b"\x00")
+        pending = bytearray(rest)
+        for frame in complete:
+            if frame:
+                yield bytes(frame)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="captured byte stream, or - for stdin")
+    parser.add_argument("--trace", help="write recorded input events here")
+    args = parser.parse_args()
+    trace = open(args.trace, "w") if args.trace else None  # noqa: SIM115
+    trace_ms = 0
+    trace_lost = 0
+    last_seq = None
+    gaps = 0
+
+    source = (
+        sys.stdin.buffer
+        if args.capture == "-"
+        else open(args.capture, "rb")  # noqa: SIM115 - closed at exit
+    )
+    writer = csv.DictWriter(sys.stdout, fieldnames=COLUMNS, extrasaction="ignore")
+    writer.writeheader()
+
+    good = bad = 0
+    for frame in frames(source):
+        decoded = cobs_decode(frame)
+        row = None
+        if decoded is not None and len(decoded) >= 2:
+            payload, crc = decoded[:-2], decoded[-2:]
+            if crc16(payload) == (crc[0] << 8 | crc[1]):
+                row = decode_record(payload)
+        if row is None:
+            if is_text(frame):
+                print(frame.decode("ascii").rstrip(), file=sys.stderr)
+            else:
+                bad += 1
+            continue
+        good += 1
+        if last_seq is not None and row["seq"] != (last_seq + 1) & 0xFF:
+            gaps += 1
+        last_seq = row["seq"]
+        if trace is not None and row["type"] == "trace":
+            for event in row["events"]:
+                if event[0] < trace_ms:
+                    print("# reset", file=trace)
+                    trace_lost = 0
+                trace_ms = event[0]
+                print(trace_line(event), file=trace)
+            # Events are lost while this record waits to go out, after its own
+            if row["trace_lost"] > trace_lost:
+                lost = row["trace_lost"] - trace_lost
+                print(f"# lost {lost} after {trace_ms}", file=trace)
+            trace_lost = row["trace_lost"]
+        writer.writerow(row)
+        if args.capture == "-":
+            sys.stdout.flush()
+
+    print(f"{good} records, {bad} bad frames", file=sys.stderr)
+    if trace is not None:
+        trace.close()
+        if gaps:
+            print(f"{gaps} sequence gaps: the trace may be incomplete", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()